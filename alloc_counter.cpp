@@ -0,0 +1,176 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Allocation Counter
+ ---------------------------------------------------------
+ * See alloc_counter.h.
+ */
+
+#include "alloc_counter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+using namespace std;
+
+#ifdef CALIB_COUNT_ALLOCATIONS
+
+namespace {
+thread_local size_t allocationCount = 0;
+}
+
+void *operator new(size_t size) {
+    allocationCount++;
+    if (void *p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept {
+    allocationCount++;
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept {
+    allocationCount++;
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+bool allocationCountingEnabled() {
+    return true;
+}
+
+size_t threadAllocationCount() {
+    return allocationCount;
+}
+
+#else
+
+bool allocationCountingEnabled() {
+    return false;
+}
+
+size_t threadAllocationCount() {
+    return 0;
+}
+
+#endif // CALIB_COUNT_ALLOCATIONS
+
+namespace {
+// Library calls named by AllocationScope on this thread; fixed size so that
+// keeping the table never allocates
+struct ScopeTable {
+    const char *names[MAX_ALLOCATION_SCOPES];
+    size_t counts[MAX_ALLOCATION_SCOPES];
+    int used = 0;
+    size_t charged = 0;  // Sum of counts
+};
+thread_local ScopeTable scopes;
+
+// -1 once the table is full: such scopes stay in the own-code count
+int scopeSlot(const char *name) {
+    for (int i = 0; i < scopes.used; i++) {
+        if (scopes.names[i] == name || strcmp(scopes.names[i], name) == 0) return i;
+    }
+    if (scopes.used == MAX_ALLOCATION_SCOPES) return -1;
+    scopes.names[scopes.used] = name;
+    scopes.counts[scopes.used] = 0;
+    return scopes.used++;
+}
+}
+
+AllocationScope::AllocationScope(const char *name)
+    : slot_(allocationCountingEnabled() ? scopeSlot(name) : -1),
+      start_(threadAllocationCount()), nestedStart_(scopes.charged) {}
+
+AllocationScope::~AllocationScope() {
+    if (slot_ < 0) return;
+    // Nested scopes have charged their share already
+    size_t own = threadAllocationCount() - start_ - (scopes.charged - nestedStart_);
+    scopes.counts[slot_] += own;
+    scopes.charged += own;
+}
+
+FrameAllocationMonitor::FrameAllocationMonitor(const string &name, int warmupFrames)
+    : name_(name), warmupFrames_(warmupFrames) {}
+
+FrameAllocationMonitor::~FrameAllocationMonitor() {
+    finish();
+}
+
+void FrameAllocationMonitor::configure(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--assert-no-alloc") assertNoAllocations_ = true;
+    }
+}
+
+void FrameAllocationMonitor::beginFrame() {
+    if (frame_ == warmupFrames_) {
+        copy(scopes.counts, scopes.counts + scopes.used, scopeBaseline_);
+    }
+    frameStart_ = threadAllocationCount();
+    scopedStart_ = scopes.charged;
+}
+
+void FrameAllocationMonitor::endFrame() {
+    if (!allocationCountingEnabled()) return;
+    // Library calls are reported per scope; the rest is the tool's own
+    size_t count = (threadAllocationCount() - frameStart_) - (scopes.charged - scopedStart_);
+    if (frame_++ < warmupFrames_) return;
+
+    measuredFrames_++;
+    if (count == 0) return;
+    if (allocatingFrames_++ == 0) firstAllocatingFrame_ = frame_ - 1;
+    maxPerFrame_ = max(maxPerFrame_, count);
+    total_ += count;
+}
+
+bool FrameAllocationMonitor::finish() {
+    bool failed = assertNoAllocations_ &&
+                  (!allocationCountingEnabled() || measuredFrames_ == 0 || allocatingFrames_ > 0);
+    if (finished_) return !failed;
+    finished_ = true;
+
+    if (!allocationCountingEnabled()) {
+        if (assertNoAllocations_) {
+            cerr << "[alloc] --assert-no-alloc needs a build that counts allocations "
+                 << "(CMAKE_BUILD_TYPE=Debug)" << endl;
+        }
+        return !failed;
+    }
+
+    cout << "[alloc] " << name_ << ": " << measuredFrames_ << " frames after "
+         << warmupFrames_ << " warm-up frames, " << allocatingFrames_ << " allocated in own code";
+    if (allocatingFrames_ > 0) {
+        cout << " (first: frame " << firstAllocatingFrame_ << ", max " << maxPerFrame_
+             << " per frame, " << total_ << " total)";
+    }
+    cout << endl;
+
+    bool header = false;
+    for (int i = 0; i < scopes.used; i++) {
+        size_t count = scopes.counts[i] - (measuredFrames_ > 0 ? scopeBaseline_[i] : scopes.counts[i]);
+        if (count == 0) continue;
+        cout << (header ? ", " : "[alloc]   library calls: ") << scopes.names[i] << " " << count;
+        header = true;
+    }
+    if (header) cout << endl;
+
+    if (failed) {
+        cerr << "[alloc] " << name_ << ": steady state is not allocation-free"
+             << (measuredFrames_ == 0 ? " (no frames after the warm-up)" : "") << endl;
+    }
+    return !failed;
+}
@@ -0,0 +1,95 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Allocation Counter (debug check for allocation-free frame loops)
+ ---------------------------------------------------------
+ * The live loops keep their frames, buffers and point lists between frames,
+ * so after a short warm-up they should not touch the heap. Debug builds
+ * (CMake defines CALIB_COUNT_ALLOCATIONS for them) replace the global
+ * operator new with one that counts allocations per thread, and a
+ * FrameAllocationMonitor brackets each loop iteration. When the loop ends it
+ * prints how many frames after the warm-up allocated, the worst frame and
+ * the first offender. In other builds the monitor does nothing.
+ *
+ * Calls into OpenCV that allocate internally (capture, detection, PnP,
+ * projection, drawing, GUI) are named with an AllocationScope where they are
+ * made, inside the shared modules as well as in the tools. Their allocations
+ * still happen, so they are not subtracted: the report splits every frame's
+ * count into the tool's own code (everything outside a scope) and a per-scope
+ * breakdown of the library calls. Only the own-code count has to reach zero.
+ * Mat pixel buffers come from cv::fastMalloc rather than operator new, but
+ * every new Mat allocation also creates its header block with new, so
+ * per-frame Mats are still caught.
+ *
+ * --assert-no-alloc makes a run a steady-state check: finish() fails if any
+ * frame after the warm-up allocated in the tool's own code (or if the build
+ * does not count), e.g.
+ *   ./bin/camera_pose --replay run.frec --replay-fast --no-display --assert-no-alloc
+ */
+
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+#include <string>
+
+const int ALLOCATION_WARMUP_FRAMES = 30;
+const int MAX_ALLOCATION_SCOPES = 32;  // Distinct scope names per thread
+
+// True in builds that count allocations
+bool allocationCountingEnabled();
+
+// Allocations made by the calling thread so far (0 when not counting)
+size_t threadAllocationCount();
+
+// Charges the allocations made inside it to the named library call; nested
+// scopes charge their own share. name must outlive the program (a literal).
+class AllocationScope {
+public:
+    explicit AllocationScope(const char *name);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+private:
+    int slot_;
+    size_t start_;
+    size_t nestedStart_;
+};
+
+class FrameAllocationMonitor {
+public:
+    explicit FrameAllocationMonitor(const std::string &name, int warmupFrames = ALLOCATION_WARMUP_FRAMES);
+    ~FrameAllocationMonitor();
+
+    // --assert-no-alloc
+    void configure(int argc, char **argv);
+
+    void beginFrame();
+    void endFrame();
+
+    // Prints the report (once; the destructor prints it otherwise). False if
+    // --assert-no-alloc was given and the steady state allocated.
+    bool finish();
+
+private:
+    std::string name_;
+    int warmupFrames_;
+    bool assertNoAllocations_ = false;
+    bool finished_ = false;
+    int frame_ = 0;
+    size_t frameStart_ = 0;
+    size_t scopedStart_ = 0;
+
+    int measuredFrames_ = 0;
+    int allocatingFrames_ = 0;
+    int firstAllocatingFrame_ = -1;
+    size_t maxPerFrame_ = 0;
+    size_t total_ = 0;
+    size_t scopeBaseline_[MAX_ALLOCATION_SCOPES] = {};  // Scope totals when measuring started
+};
+
+#endif // ALLOC_COUNTER_H
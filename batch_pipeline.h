@@ -0,0 +1,342 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Batch Pipeline (shared by the static-image AR tools)
+ ---------------------------------------------------------
+ * Runs a per-image function over a directory or list file without any GUI.
+ * Decode, process and encode/write are separate stages connected by bounded
+ * queues, so at most a fixed number of images are in memory at once while
+ * all three stages run concurrently.
+ *
+ * A CSV manifest with one row per input (status, timing, tool-specific info)
+ * grows as images finish, flushed every MANIFEST_FLUSH_ROWS rows, so an
+ * interrupted run still records what completed. When the batch finishes it
+ * is rewritten in input order.
+ */
+
+#ifndef BATCH_PIPELINE_H
+#define BATCH_PIPELINE_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Blocking FIFO with a fixed capacity; close() wakes all waiters
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    // Returns false if the queue was closed before the item could be queued
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [&] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // Returns false once the queue is closed and drained
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [&] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_, notFull_;
+};
+
+const size_t MANIFEST_FLUSH_ROWS = 100;
+
+// One image travelling through the pipeline
+struct BatchJob {
+    size_t index = 0;
+    std::string inputPath;
+    std::string outputPath;
+    cv::Mat image;          // Decoded input, replaced by the rendered output
+    bool ok = false;
+    std::string status;     // "ok" or a short failure reason
+    std::string info;       // Tool-specific manifest column
+    double processMs = 0.0;
+};
+
+// Process job.image in place; set status/info and return success
+using BatchProcessor = std::function<bool(BatchJob &)>;
+
+struct BatchOptions {
+    int jobs = 0;                     // Processing threads, 0 = hardware concurrency
+    int decodeThreads = 2;
+    int writeThreads = 2;
+    size_t queueDepth = 0;            // Images per queue, 0 = 2 * jobs
+    std::string outputDir;            // Empty = next to each input
+    std::string manifestPath = "batch_manifest.csv";
+};
+
+inline bool isBatchImageFile(const std::filesystem::path &p) {
+    std::string ext = p.extension().string();
+    for (auto &ch : ext) ch = (char)std::tolower(ch);
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".tiff";
+}
+
+// Inputs from a directory (sorted image files) or a text file with one path per line
+inline std::vector<std::string> collectBatchInputs(const std::string &source) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> inputs;
+    if (fs::is_directory(source)) {
+        for (auto &p : fs::directory_iterator(source)) {
+            if (p.is_regular_file() && isBatchImageFile(p.path())) inputs.push_back(p.path().string());
+        }
+        std::sort(inputs.begin(), inputs.end());
+    } else {
+        std::ifstream list(source);
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty() && line[0] != '#') inputs.push_back(line);
+        }
+    }
+    return inputs;
+}
+
+// <name>_with_ar.<ext>, optionally redirected into outputDir
+inline std::string batchOutputPath(const std::string &input, const std::string &outputDir) {
+    namespace fs = std::filesystem;
+    fs::path in(input);
+    std::string name = in.stem().string() + "_with_ar" + in.extension().string();
+    return outputDir.empty() ? (in.parent_path() / name).string() : (fs::path(outputDir) / name).string();
+}
+
+// Output path of every input. Inputs that would write the same file (equal
+// names from different directories with --out, or repeated list entries)
+// get their input index appended: img001_with_ar_17.png
+inline std::vector<std::string> batchOutputPaths(const std::vector<std::string> &inputs,
+                                                 const std::string &outputDir) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> outputs;
+    std::map<std::string, int> uses;
+    for (const auto &input : inputs) {
+        outputs.push_back(batchOutputPath(input, outputDir));
+        uses[fs::path(outputs.back()).lexically_normal().string()]++;
+    }
+    int renamed = 0;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (uses[fs::path(outputs[i]).lexically_normal().string()] < 2) continue;
+        fs::path out(outputs[i]);
+        out.replace_filename(out.stem().string() + "_" + std::to_string(i) + out.extension().string());
+        outputs[i] = out.string();
+        renamed++;
+    }
+    if (renamed > 0) {
+        std::cout << renamed << " inputs share an output name; their index is appended" << std::endl;
+    }
+    return outputs;
+}
+
+// RFC 4180 field: quoted, with quotes doubled, when it holds a delimiter
+inline std::string csvField(const std::string &value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+inline void writeManifestHeader(std::ostream &out) {
+    out << "index,input,output,status,process_ms,info\n";
+}
+
+inline void writeManifestRow(std::ostream &out, const BatchJob &job) {
+    out << job.index << "," << csvField(job.inputPath) << "," << csvField(job.ok ? job.outputPath : "") << ","
+        << csvField(job.status) << "," << job.processMs << "," << csvField(job.info) << "\n";
+}
+
+// Run decode -> process -> write over all inputs and write the manifest.
+// Returns the number of images that failed.
+inline int runBatch(const std::vector<std::string> &inputs, const BatchProcessor &process,
+                    BatchOptions options) {
+    if (options.jobs <= 0) options.jobs = std::max(1u, std::thread::hardware_concurrency());
+    if (options.queueDepth == 0) options.queueDepth = 2 * (size_t)options.jobs;
+    if (!options.outputDir.empty()) std::filesystem::create_directories(options.outputDir);
+
+    // Parallelism comes from the pipeline; keep OpenCV from oversubscribing
+    cv::setNumThreads(1);
+
+    BoundedQueue<BatchJob> decoded(options.queueDepth);
+    BoundedQueue<BatchJob> processed(options.queueDepth);
+    std::vector<std::string> outputs = batchOutputPaths(inputs, options.outputDir);
+    std::vector<BatchJob> results(inputs.size());
+    std::mutex resultsMutex;
+    std::atomic<size_t> nextInput(0);
+    std::atomic<size_t> done(0);
+
+    // Rows in completion order while running (see above)
+    std::ofstream manifest(options.manifestPath);
+    writeManifestHeader(manifest);
+
+    auto record = [&](BatchJob &job) {
+        job.image.release();
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        writeManifestRow(manifest, job);
+        results[job.index] = std::move(job);
+        size_t count = ++done;
+        if (count % MANIFEST_FLUSH_ROWS == 0 || count == inputs.size()) {
+            manifest.flush();
+            std::cout << "  " << count << "/" << inputs.size() << " images" << std::endl;
+        }
+    };
+
+    // Stage 1: decode
+    std::vector<std::thread> decoders;
+    std::atomic<int> decodersLeft(options.decodeThreads);
+    for (int t = 0; t < options.decodeThreads; t++) {
+        decoders.emplace_back([&] {
+            size_t i;
+            while ((i = nextInput++) < inputs.size()) {
+                BatchJob job;
+                job.index = i;
+                job.inputPath = inputs[i];
+                job.outputPath = outputs[i];
+                job.image = cv::imread(inputs[i]);
+                if (job.image.empty()) {
+                    job.status = "decode_failed";
+                    record(job);
+                    continue;
+                }
+                decoded.push(std::move(job));
+            }
+            if (--decodersLeft == 0) decoded.close();
+        });
+    }
+
+    // Stage 2: detect / solve / render
+    std::vector<std::thread> workers;
+    std::atomic<int> workersLeft(options.jobs);
+    for (int t = 0; t < options.jobs; t++) {
+        workers.emplace_back([&] {
+            BatchJob job;
+            while (decoded.pop(job)) {
+                int64 start = cv::getTickCount();
+                // One bad image (cv::Exception from a malformed frame, ...) must
+                // not end the whole batch
+                try {
+                    job.ok = process(job);
+                } catch (const std::exception &e) {
+                    job.ok = false;
+                    job.status = "exception";
+                    job.info = e.what();
+                } catch (...) {
+                    job.ok = false;
+                    job.status = "exception";
+                    job.info = "unknown exception";
+                }
+                job.processMs = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+                if (job.ok) {
+                    processed.push(std::move(job));
+                } else {
+                    record(job);
+                }
+            }
+            if (--workersLeft == 0) processed.close();
+        });
+    }
+
+    // Stage 3: encode / write
+    std::vector<std::thread> writers;
+    for (int t = 0; t < options.writeThreads; t++) {
+        writers.emplace_back([&] {
+            BatchJob job;
+            while (processed.pop(job)) {
+                bool written = false;
+                try {
+                    written = cv::imwrite(job.outputPath, job.image);
+                } catch (const std::exception &e) {
+                    job.info = e.what();
+                }
+                if (!written) {
+                    job.ok = false;
+                    job.status = "write_failed";
+                } else if (job.status.empty()) {
+                    job.status = "ok";
+                }
+                record(job);
+            }
+        });
+    }
+
+    for (auto &t : decoders) t.join();
+    for (auto &t : workers) t.join();
+    for (auto &t : writers) t.join();
+
+    // Rewrite in input order; the running manifest stays if this fails
+    manifest.close();
+    std::string sortedPath = options.manifestPath + ".tmp";
+    std::ofstream sorted(sortedPath);
+    writeManifestHeader(sorted);
+    int failures = 0;
+    for (const auto &job : results) {
+        if (!job.ok) failures++;
+        writeManifestRow(sorted, job);
+    }
+    sorted.close();
+    std::error_code ec;
+    if (sorted) std::filesystem::rename(sortedPath, options.manifestPath, ec);
+    if (!sorted || ec) std::cerr << "Warning: manifest left in completion order" << std::endl;
+    std::cout << "Manifest written to: " << options.manifestPath << std::endl;
+    return failures;
+}
+
+// Parse "--batch <source> [--jobs N] [--out dir] [--manifest file]" from argv
+inline bool parseBatchArgs(int argc, char **argv, std::string &source, BatchOptions &options) {
+    bool batch = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--batch" && i + 1 < argc) {
+            source = argv[++i];
+            batch = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            options.jobs = std::atoi(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            options.manifestPath = argv[++i];
+        }
+    }
+    return batch;
+}
+
+#endif // BATCH_PIPELINE_H
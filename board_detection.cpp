@@ -0,0 +1,174 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Detection
+ ---------------------------------------------------------
+ * See board_detection.h.
+ */
+
+#include "board_detection.h"
+#include "board_subpix.h"
+#include "alloc_counter.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+// findChessboardCorners allocates internally; charged to it (alloc_counter.h)
+static bool findCorners(const Mat &image, Size patternSize, vector<Point2f> &corners, int flags) {
+    AllocationScope scope("findChessboardCorners");
+    return findChessboardCorners(image, patternSize, corners, flags);
+}
+
+vector<Point3f> boardObjectPoints(Size patternSize, float squareSize) {
+    vector<Point3f> points;
+    points.reserve(patternSize.area());
+    for (int i = 0; i < patternSize.height; i++) {
+        for (int j = 0; j < patternSize.width; j++) {
+            points.push_back(Point3f(j * squareSize, i * squareSize, 0));
+        }
+    }
+    return points;
+}
+
+void refineReducedCorners(const Mat &gray, double scale, ReducedImage reduction, Size patternSize,
+                          vector<Point2f> &corners, const TermCriteria &criteria, SubpixMethod subpix) {
+    double offset = reduction == ReducedImage::Resized ? 0.5 : 0.0;
+    for (auto &pt : corners) {
+        pt.x = (float)((pt.x + offset) / scale - offset);
+        pt.y = (float)((pt.y + offset) / scale - offset);
+    }
+
+    // Grow the search window with the upscaling error, capped below the
+    // smallest square so neighbouring corners stay out of the window
+    float minSpacing = FLT_MAX;
+    for (int r = 0; r < patternSize.height; r++) {
+        for (int c = 0; c + 1 < patternSize.width; c++) {
+            Point2f d = corners[r * patternSize.width + c + 1] - corners[r * patternSize.width + c];
+            minSpacing = min(minSpacing, sqrt(d.x * d.x + d.y * d.y));
+        }
+    }
+    int halfWin = max(11, (int)ceil(2.0 / scale));
+    halfWin = max(2, min(halfWin, (int)(minSpacing * 0.5f) - 1));
+    refineBoardCorners(gray, corners, Size(halfWin, halfWin), criteria, subpix);
+}
+
+// Search on the reduced image, map back and refine on the full frame
+static bool refineFromReduced(const Mat &gray, const Mat &small, double scale, ReducedImage reduction,
+                              Size patternSize, vector<Point2f> &corners, int flags,
+                              const TermCriteria &criteria, SubpixMethod subpix) {
+    if (!findCorners(small, patternSize, corners, flags)) return false;
+    refineReducedCorners(gray, scale, reduction, patternSize, corners, criteria, subpix);
+    return true;
+}
+
+bool detectBoardCorners(const Mat &gray, Size patternSize, vector<Point2f> &corners,
+                        int flags, const TermCriteria &criteria, int maxDetectionWidth,
+                        SubpixMethod subpix) {
+    double scale = 1.0;
+    if (maxDetectionWidth > 0 && gray.cols > maxDetectionWidth) {
+        scale = (double)maxDetectionWidth / gray.cols;
+    }
+
+    if (scale == 1.0) {
+        if (!findCorners(gray, patternSize, corners, flags)) return false;
+        refineBoardCorners(gray, corners, BOARD_SUBPIX_WINDOW, criteria, subpix);
+        return true;
+    }
+
+    Mat small;
+    resize(gray, small, Size(), scale, scale, INTER_AREA);
+    return refineFromReduced(gray, small, scale, ReducedImage::Resized, patternSize, corners, flags, criteria,
+                             subpix);
+}
+
+bool detectBoardCorners(FramePyramid &pyramid, Size patternSize, vector<Point2f> &corners,
+                        int flags, const TermCriteria &criteria, int maxDetectionWidth,
+                        SubpixMethod subpix) {
+    const Mat &gray = pyramid.level(0);
+    int lvl = maxDetectionWidth > 0 ? pyramid.levelForWidth(maxDetectionWidth) : 0;
+
+    // An empty view is the slowest case for findChessboardCorners
+    if (!boardLikelyPresent(pyramid, patternSize, maxDetectionWidth)) return false;
+
+    if (lvl == 0) {
+        if (!findCorners(gray, patternSize, corners, flags)) return false;
+        refineBoardCorners(gray, corners, BOARD_SUBPIX_WINDOW, criteria, subpix);
+        return true;
+    }
+
+    return refineFromReduced(gray, pyramid.level(lvl), 1.0 / (1 << lvl), ReducedImage::PyramidLevel,
+                             patternSize, corners, flags, criteria, subpix);
+}
+
+bool boardLikelyPresent(FramePyramid &pyramid, Size patternSize, int maxDetectionWidth) {
+    int lvl = maxDetectionWidth > 0 ? pyramid.levelForWidth(maxDetectionWidth) : 0;
+    return boardLikelyPresent(pyramid.level(min(lvl + 1, pyramid.numLevels() - 1)), patternSize);
+}
+
+int reducedDetectionWidth(int frameWidth) {
+    return max(MIN_REDUCED_DETECTION_WIDTH, min(frameWidth, DEFAULT_DETECTION_WIDTH) / 2);
+}
+
+void drawPoseAxes(Mat &frame, const Mat &rvec, const Mat &tvec,
+                  const Mat &cameraMatrix, const Mat &distCoeffs, float length) {
+    // Stack arrays wrapped in Mat headers: called every frame, allocates nothing
+    Point3f axisPoints[4] = {Point3f(0, 0, 0), Point3f(length, 0, 0),
+                             Point3f(0, length, 0), Point3f(0, 0, -length)};
+    Point2f imagePoints[4];
+    Mat imageMat(4, 1, CV_32FC2, imagePoints);
+    AllocationScope scope("projectPoints+line");
+    projectPoints(Mat(4, 1, CV_32FC3, axisPoints), rvec, tvec, cameraMatrix, distCoeffs, imageMat);
+
+    line(frame, imagePoints[0], imagePoints[1], Scalar(0, 0, 255), 2);  // X-axis red
+    line(frame, imagePoints[0], imagePoints[2], Scalar(0, 255, 0), 2);  // Y-axis green
+    line(frame, imagePoints[0], imagePoints[3], Scalar(255, 0, 0), 2);  // Z-axis blue
+}
+
+Mat renderSyntheticBoard(Size patternSize, Size imageSize, double tilt, vector<Point2f> *trueCorners) {
+    // Flat board: (pattern + 1) squares plus a one-square white margin
+    const int square = 64;
+    Size squares(patternSize.width + 1, patternSize.height + 1);
+    Mat flat(Size((squares.width + 2) * square, (squares.height + 2) * square), CV_8UC1, Scalar(255));
+    for (int r = 0; r < squares.height; r++) {
+        for (int c = 0; c < squares.width; c++) {
+            if ((r + c) % 2 == 0) {
+                rectangle(flat, Rect((c + 1) * square, (r + 1) * square, square, square), Scalar(0), FILLED);
+            }
+        }
+    }
+
+    // Board fills about 70% of the image; the top edge is narrowed by tilt
+    float w = (float)imageSize.width, h = (float)imageSize.height;
+    float bw = 0.7f * w, bh = bw * flat.rows / flat.cols;
+    if (bh > 0.7f * h) {
+        bh = 0.7f * h;
+        bw = bh * flat.cols / flat.rows;
+    }
+    float x0 = (w - bw) / 2, y0 = (h - bh) / 2;
+    float inset = (float)(tilt * bw * 0.25);
+    vector<Point2f> src = {Point2f(-0.5f, -0.5f), Point2f(flat.cols - 0.5f, -0.5f),
+                           Point2f(flat.cols - 0.5f, flat.rows - 0.5f), Point2f(-0.5f, flat.rows - 0.5f)};
+    vector<Point2f> dst = {Point2f(x0 + inset, y0), Point2f(x0 + bw - inset, y0),
+                           Point2f(x0 + bw, y0 + bh), Point2f(x0, y0 + bh)};
+    Mat H = getPerspectiveTransform(src, dst);
+
+    Mat image;
+    warpPerspective(flat, image, H, imageSize, INTER_LINEAR, BORDER_CONSTANT, Scalar(255));
+
+    if (trueCorners) {
+        // Inner corner (j, i) lies between pixels, at k * square - 0.5
+        vector<Point2f> flatCorners;
+        for (int i = 0; i < patternSize.height; i++) {
+            for (int j = 0; j < patternSize.width; j++) {
+                flatCorners.push_back(Point2f((j + 2) * square - 0.5f, (i + 2) * square - 0.5f));
+            }
+        }
+        perspectiveTransform(flatCorners, *trueCorners, H);
+    }
+    return image;
+}
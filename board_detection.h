@@ -0,0 +1,88 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Detection (shared checkerboard helpers)
+ ---------------------------------------------------------
+ * Board geometry, detection, pose-axis drawing and synthetic test boards
+ * used by all checkerboard tools and the benchmark.
+ *
+ * Reduced-resolution detection: findChessboardCorners runs on a copy of the
+ * frame downscaled to at most maxDetectionWidth pixels wide, the corners are
+ * mapped back and refined (board_subpix.h) on the full-resolution image.
+ * The expensive search then costs the same at 4K as at 720p, while the
+ * returned corners keep full-resolution accuracy.
+ *
+ * The FramePyramid overload searches on the first pyramid level that fits
+ * maxDetectionWidth instead of resizing, sharing the level with the other
+ * stages that process the same frame. It also runs the board presence check
+ * (board_presence.h) one level further down first, so frames without a board
+ * skip the search entirely.
+ */
+
+#ifndef BOARD_DETECTION_H
+#define BOARD_DETECTION_H
+
+#include <opencv2/opencv.hpp>
+#include "frame_pyramid.h"
+#include "board_presence.h"
+#include "board_subpix.h"
+#include <vector>
+
+const cv::Size BOARD_PATTERN_SIZE(9, 6);  // Inner corners of the printed board
+const int DEFAULT_DETECTION_WIDTH = 1280;  // Frames wider than this are detected downscaled
+const int MIN_REDUCED_DETECTION_WIDTH = 320;
+const int LIVE_BOARD_FLAGS = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
+// Corner refinement: the live tools stop at 0.01 px, the calibration tools
+// (calibrate_camera, camera_comparison) keep refining to 0.001 px, as every
+// view's error goes into the intrinsics
+const cv::Size BOARD_SUBPIX_WINDOW(11, 11);
+const cv::TermCriteria BOARD_SUBPIX_CRITERIA(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.01);
+const cv::TermCriteria CALIBRATION_SUBPIX_CRITERIA(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.001);
+
+// Board corners in board coordinates (z = 0), row by row
+std::vector<cv::Point3f> boardObjectPoints(cv::Size patternSize, float squareSize);
+
+// Detect and refine board corners; maxDetectionWidth <= 0 disables downscaling
+bool detectBoardCorners(const cv::Mat &gray, cv::Size patternSize, std::vector<cv::Point2f> &corners,
+                        int flags = LIVE_BOARD_FLAGS, const cv::TermCriteria &criteria = BOARD_SUBPIX_CRITERIA,
+                        int maxDetectionWidth = DEFAULT_DETECTION_WIDTH,
+                        SubpixMethod subpix = SubpixMethod::Gradient);
+bool detectBoardCorners(FramePyramid &pyramid, cv::Size patternSize, std::vector<cv::Point2f> &corners,
+                        int flags = LIVE_BOARD_FLAGS, const cv::TermCriteria &criteria = BOARD_SUBPIX_CRITERIA,
+                        int maxDetectionWidth = DEFAULT_DETECTION_WIDTH,
+                        SubpixMethod subpix = SubpixMethod::Gradient);
+
+// Detection width for frames behind schedule (see frame_scheduler.h): half
+// the normal detection width, but not below MIN_REDUCED_DETECTION_WIDTH
+int reducedDetectionWidth(int frameWidth);
+
+// How a reduced image was made, which decides where its pixel centres lie:
+// resize(INTER_AREA) maps p to (p + 0.5) / scale - 0.5, while pyrDown
+// centres level pixel p on full-resolution pixel p * 2^level
+enum class ReducedImage { Resized, PyramidLevel };
+
+// Corners found on an image downscaled by `scale` (2^-level for pyramid
+// levels): map them to the full gray image and refine there with a window
+// sized for the upscaling error
+void refineReducedCorners(const cv::Mat &gray, double scale, ReducedImage reduction, cv::Size patternSize,
+                          std::vector<cv::Point2f> &corners,
+                          const cv::TermCriteria &criteria = BOARD_SUBPIX_CRITERIA,
+                          SubpixMethod subpix = SubpixMethod::Gradient);
+
+// Presence check on the level below the one detectBoardCorners would search
+// (maxDetectionWidth <= 0: below full resolution)
+bool boardLikelyPresent(FramePyramid &pyramid, cv::Size patternSize,
+                        int maxDetectionWidth = DEFAULT_DETECTION_WIDTH);
+
+// X (red), Y (green) and Z (blue, off the board) axes of the given length
+void drawPoseAxes(cv::Mat &frame, const cv::Mat &rvec, const cv::Mat &tvec,
+                  const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs, float length);
+
+// Grayscale image of a board seen under a mild perspective, with the exact
+// corner positions; tilt in [0, 1) skews the far edge inwards
+cv::Mat renderSyntheticBoard(cv::Size patternSize, cv::Size imageSize, double tilt,
+                             std::vector<cv::Point2f> *trueCorners = nullptr);
+
+#endif // BOARD_DETECTION_H
@@ -0,0 +1,249 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Detector
+ ---------------------------------------------------------
+ * See board_detector.h.
+ */
+
+#include "board_detector.h"
+#include "alloc_counter.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+class ClassicBoardDetector : public BoardDetector {
+public:
+    explicit ClassicBoardDetector(int flags) : flags_(flags) {}
+    string name() const override { return "classic"; }
+
+    bool detect(FramePyramid &pyramid, Size patternSize, vector<Point2f> &corners) override {
+        return detectBoardCorners(pyramid, patternSize, corners, flags_, BOARD_SUBPIX_CRITERIA,
+                                  maxDetectionWidth_, subpixMethod_);
+    }
+
+private:
+    int flags_;
+};
+
+class SectorBoardDetector : public BoardDetector {
+public:
+    string name() const override { return "sb"; }
+
+    bool detect(FramePyramid &pyramid, Size patternSize, vector<Point2f> &corners) override {
+        if (!boardLikelyPresent(pyramid, patternSize, maxDetectionWidth_)) return false;
+        int lvl = maxDetectionWidth_ > 0 ? pyramid.levelForWidth(maxDetectionWidth_) : 0;
+        const Mat &search = pyramid.level(lvl);
+        {
+            AllocationScope scope("findChessboardCornersSB");
+            if (!findChessboardCornersSB(search, patternSize, corners, SB_BOARD_FLAGS)) return false;
+        }
+
+        // SB corners are subpixel already; only a reduced search needs refining
+        if (lvl > 0) {
+            const Mat &gray = pyramid.level(0);
+            refineReducedCorners(gray, 1.0 / (1 << lvl), ReducedImage::PyramidLevel, patternSize, corners,
+                                 BOARD_SUBPIX_CRITERIA, subpixMethod_);
+        }
+        return true;
+    }
+};
+
+double median(vector<double> values) {
+    if (values.empty()) return 0.0;
+    nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+class AutoBoardDetector : public BoardDetector {
+public:
+    explicit AutoBoardDetector(int flags) {
+        candidates_.push_back(make_unique<ClassicBoardDetector>(flags));
+        candidates_.push_back(make_unique<SectorBoardDetector>());
+        trials_.resize(candidates_.size());
+    }
+
+    string name() const override { return chosen_ ? "auto:" + chosen_->name() : "auto"; }
+
+    void setMaxDetectionWidth(int width) override {
+        BoardDetector::setMaxDetectionWidth(width);
+        for (auto &c : candidates_) c->setMaxDetectionWidth(width);
+    }
+
+    void setSubpixMethod(SubpixMethod method) override {
+        BoardDetector::setSubpixMethod(method);
+        for (auto &c : candidates_) c->setSubpixMethod(method);
+    }
+
+    bool detect(FramePyramid &pyramid, Size patternSize, vector<Point2f> &corners) override {
+        if (chosen_) return chosen_->detect(pyramid, patternSize, corners);
+        return trial(pyramid, patternSize, corners);
+    }
+
+private:
+    struct Trial {
+        vector<double> ms;         // Frames with a board
+        vector<double> residuals;  // Frames this backend found it in
+    };
+
+    bool trial(FramePyramid &pyramid, Size patternSize, vector<Point2f> &corners);
+    void choose();
+
+    vector<unique_ptr<BoardDetector>> candidates_;
+    vector<Trial> trials_;
+    vector<double> frameMs_, frameResidual_;
+    vector<Point2f> trialCorners_;
+    BoardDetector *chosen_ = nullptr;
+    int frames_ = 0;
+    int boardFrames_ = 0;
+};
+
+// Every backend on this frame, returning the most accurate result
+bool AutoBoardDetector::trial(FramePyramid &pyramid, Size patternSize, vector<Point2f> &corners) {
+    size_t n = candidates_.size();
+    frameMs_.assign(n, 0.0);
+    frameResidual_.assign(n, -1.0);
+    double best = DBL_MAX;
+
+    // Pyramid levels are cached once built: rotate the order so no backend
+    // always gets them for free
+    for (size_t k = 0; k < n; k++) {
+        size_t i = (k + frames_) % n;
+        int64 start = getTickCount();
+        bool found = candidates_[i]->detect(pyramid, patternSize, trialCorners_);
+        frameMs_[i] = (getTickCount() - start) * 1000.0 / getTickFrequency();
+        if (!found) continue;
+
+        frameResidual_[i] = boardCornerResidual(trialCorners_, patternSize);
+        if (frameResidual_[i] < best) {
+            best = frameResidual_[i];
+            corners.assign(trialCorners_.begin(), trialCorners_.end());
+        }
+    }
+    frames_++;
+    if (best == DBL_MAX) return false;
+
+    boardFrames_++;
+    for (size_t i = 0; i < n; i++) {
+        trials_[i].ms.push_back(frameMs_[i]);
+        if (frameResidual_[i] >= 0) trials_[i].residuals.push_back(frameResidual_[i]);
+    }
+    if (boardFrames_ >= AUTO_SELECT_BOARD_FRAMES) choose();
+    return true;
+}
+
+void AutoBoardDetector::choose() {
+    cout << "[detector] " << boardFrames_ << " frames with a board (" << frames_ << " frames):" << endl;
+    int fastest = -1, mostAccurate = -1;
+    double fastestMs = DBL_MAX, bestResidual = DBL_MAX;
+    for (size_t i = 0; i < candidates_.size(); i++) {
+        const Trial &t = trials_[i];
+        int found = (int)t.residuals.size();
+        double ms = median(t.ms), residual = median(t.residuals);
+        bool accurate = found > 0 && found >= AUTO_SELECT_MIN_FOUND * boardFrames_ &&
+                        residual <= BOARD_ACCURACY_TARGET_PX;
+
+        cout << "[detector]   " << left << setw(8) << candidates_[i]->name() << fixed << setprecision(2)
+             << setw(8) << ms << " ms median, found " << found << "/" << boardFrames_;
+        if (found > 0) cout << ", residual " << setprecision(3) << residual << " px";
+        if (!accurate) cout << " (misses the target)";
+        cout << endl;
+
+        if (accurate && ms < fastestMs) {
+            fastest = (int)i;
+            fastestMs = ms;
+        }
+        if (found > 0 && residual < bestResidual) {
+            mostAccurate = (int)i;
+            bestResidual = residual;
+        }
+    }
+
+    int pick = fastest >= 0 ? fastest : max(mostAccurate, 0);
+    chosen_ = candidates_[pick].get();
+    cout << "[detector] using " << chosen_->name();
+    if (fastest < 0) cout << " (no backend met the " << BOARD_ACCURACY_TARGET_PX << " px target)";
+    cout << endl;
+    trials_.clear();
+}
+
+} // namespace
+
+unique_ptr<BoardDetector> createBoardDetector(const string &name, int flags) {
+    if (name == "classic") return make_unique<ClassicBoardDetector>(flags);
+    if (name == "sb") return make_unique<SectorBoardDetector>();
+    if (name == "auto") return make_unique<AutoBoardDetector>(flags);
+    return nullptr;
+}
+
+string detectorNameFromArgs(int argc, char **argv) {
+    string name = "auto";
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--detector") name = argv[++i];
+    }
+    return name;
+}
+
+unique_ptr<BoardDetector> createBoardDetector(int argc, char **argv, int flags) {
+    string name = detectorNameFromArgs(argc, argv);
+    unique_ptr<BoardDetector> detector = createBoardDetector(name, flags);
+    if (!detector) {
+        cerr << "Warning: Unknown detector " << name << ", using auto" << endl;
+        detector = createBoardDetector("auto", flags);
+    } else if (name != "auto") {
+        cout << "[detector] using " << detector->name() << endl;
+    }
+
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) != "--subpix") continue;
+        string method = argv[++i];
+        if (method == "saddle") {
+            detector->setSubpixMethod(SubpixMethod::Saddle);
+            cout << "[detector] saddle-point corner refinement" << endl;
+        } else if (method != "gradient") {
+            cerr << "Warning: Unknown subpix method " << method << ", using gradient" << endl;
+        }
+    }
+    return detector;
+}
+
+double boardCornerResidual(const vector<Point2f> &corners, Size patternSize) {
+    CV_Assert((int)corners.size() == patternSize.area());
+    const int w = patternSize.width;
+    double sum = 0.0;
+    int count = 0;
+    vector<Point2f> grid, image;
+    for (int r = 1; r + 1 < patternSize.height; r++) {
+        for (int c = 1; c + 1 < w; c++) {
+            grid.clear();
+            image.clear();
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if (dr == 0 && dc == 0) continue;
+                    grid.push_back(Point2f((float)(c + dc), (float)(r + dr)));
+                    image.push_back(corners[(r + dr) * w + c + dc]);
+                }
+            }
+
+            // Least squares over all eight neighbours
+            Mat H = findHomography(grid, image, 0);
+            if (H.empty()) continue;
+            Matx33d h = H;
+            Vec3d p = h * Vec3d(c, r, 1);
+            double dx = p[0] / p[2] - corners[r * w + c].x;
+            double dy = p[1] / p[2] - corners[r * w + c].y;
+            sum += dx * dx + dy * dy;
+            count++;
+        }
+    }
+    return count ? sqrt(sum / count) : 0.0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Detector (interchangeable checkerboard detection backends)
+ ---------------------------------------------------------
+ * The live tools find the board through a BoardDetector instead of calling
+ * findChessboardCorners themselves, so the backend is chosen in one place:
+ *   classic  findChessboardCorners + cornerSubPix (detectBoardCorners)
+ *   sb       findChessboardCornersSB, subpixel accurate by itself
+ *   auto     the fastest of the above that is accurate enough on this
+ *            camera, chosen at startup (default)
+ * Both backends share the presence check and the reduced-resolution search
+ * of board_detection.h. --subpix saddle switches the corner refinement of the
+ * classic backend, and of reduced-resolution SB searches, from the gradient
+ * method to the faster, less accurate saddle fit (board_subpix.h).
+ *
+ * Auto selection runs every backend on the first AUTO_SELECT_BOARD_FRAMES
+ * frames that show a board, timing each. Accuracy needs no calibration:
+ * every interior corner is predicted from its eight neighbours through a
+ * homography fitted to them, and the RMS prediction error is the backend's
+ * corner noise (lens distortion is smooth at that scale and barely adds
+ * to it). The fastest backend that finds the board in nearly every such
+ * frame and stays within BOARD_ACCURACY_TARGET_PX wins; if none does, the
+ * most accurate one. The timings and the choice are printed.
+ */
+
+#ifndef BOARD_DETECTOR_H
+#define BOARD_DETECTOR_H
+
+#include <opencv2/opencv.hpp>
+#include "board_detection.h"
+#include "frame_pyramid.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+const int SB_BOARD_FLAGS = cv::CALIB_CB_NORMALIZE_IMAGE;
+const int AUTO_SELECT_BOARD_FRAMES = 10;    // Frames with a board before choosing
+const double AUTO_SELECT_MIN_FOUND = 0.9;   // Of the frames any backend found the board in
+const double BOARD_ACCURACY_TARGET_PX = 0.25;
+
+class BoardDetector {
+public:
+    virtual ~BoardDetector() = default;
+    virtual std::string name() const = 0;
+
+    // Corners at full resolution, row by row; pyramid holds the current frame
+    virtual bool detect(FramePyramid &pyramid, cv::Size patternSize, std::vector<cv::Point2f> &corners) = 0;
+
+    // Widest image searched, as in detectBoardCorners; <= 0 for full resolution
+    virtual void setMaxDetectionWidth(int width) { maxDetectionWidth_ = width; }
+
+    // Refinement of the corners this detector does not refine by itself
+    virtual void setSubpixMethod(SubpixMethod method) { subpixMethod_ = method; }
+    SubpixMethod subpixMethod() const { return subpixMethod_; }
+
+protected:
+    int maxDetectionWidth_ = DEFAULT_DETECTION_WIDTH;
+    SubpixMethod subpixMethod_ = SubpixMethod::Gradient;
+};
+
+// "classic", "sb" or "auto"; null for an unknown name. flags apply to the
+// classic backend.
+std::unique_ptr<BoardDetector> createBoardDetector(const std::string &name, int flags = LIVE_BOARD_FLAGS);
+
+// Backend from --detector <name> in the arguments, auto by default, with
+// --subpix gradient|saddle applied
+std::unique_ptr<BoardDetector> createBoardDetector(int argc, char **argv, int flags = LIVE_BOARD_FLAGS);
+
+// The --detector name alone, for tools that need one detector per thread
+std::string detectorNameFromArgs(int argc, char **argv);
+
+// RMS error (px) of predicting each interior corner from its neighbours;
+// 0 for patterns without interior corners
+double boardCornerResidual(const std::vector<cv::Point2f> &corners, cv::Size patternSize);
+
+#endif // BOARD_DETECTOR_H
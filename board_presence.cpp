@@ -0,0 +1,85 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Presence Check
+ ---------------------------------------------------------
+ * See board_presence.h.
+ */
+
+#include "board_presence.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+// Bresenham circle of radius 3, clockwise from the top: sample n + 8 is
+// opposite sample n, sample n + 4 is a quarter turn away
+static const int RING_X[16] = {0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1};
+static const int RING_Y[16] = {-3, -3, -2, -1, 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3};
+static_assert(PRESENCE_RING_RADIUS == 3, "ring offsets are for radius 3");
+
+// Responses for every second pixel of row y, from x = radius on; values
+// below threshold are only upper bounds
+static void ringResponses(const Mat &gray, int y, int count, int threshold, int *out) {
+    const int r = PRESENCE_RING_RADIUS;
+    const uchar *row = gray.ptr<uchar>(y);
+    int offsets[16];
+    for (int n = 0; n < 16; n++) offsets[n] = RING_Y[n] * (int)gray.step + RING_X[n];
+
+    for (int i = 0; i < count; i++) {
+        const uchar *p = row + r + 2 * i;
+        int s[16];
+        for (int n = 0; n < 16; n++) s[n] = p[offsets[n]];
+
+        // Checker corner: opposite samples agree, quarter turns disagree
+        int sum = 0, diff = 0;
+        for (int n = 0; n < 4; n++) sum += abs(s[n] + s[n + 8] - s[n + 4] - s[n + 12]);
+        if (sum < threshold) {
+            out[i] = sum;  // Below threshold either way; most pixels stop here
+            continue;
+        }
+        for (int n = 0; n < 8; n++) diff += abs(s[n] - s[n + 8]);
+        out[i] = sum - diff;
+    }
+}
+
+int countBoardCornerCandidates(const Mat &gray, int maxCount) {
+    CV_Assert(gray.type() == CV_8UC1);
+    const int r = PRESENCE_RING_RADIUS;
+    int cols = (gray.cols - 2 * r + 1) / 2, rows = (gray.rows - 2 * r + 1) / 2;
+    if (cols < 3 || rows < 3) return 0;
+
+    // An ideal corner of contrast C scores 8C; blur and sampling off the
+    // exact corner roughly halve that
+    const int threshold = 4 * PRESENCE_MIN_CONTRAST;
+
+    // Three rolling rows of responses, reused across calls
+    thread_local vector<int> buffer;
+    buffer.resize(3 * cols);
+    int *lines[3] = {&buffer[0], &buffer[cols], &buffer[2 * cols]};
+
+    int count = 0;
+    for (int j = 0; j < rows; j++) {
+        ringResponses(gray, r + 2 * j, cols, threshold, lines[j % 3]);
+        if (j < 2) continue;
+
+        // Local maxima of row j - 1; ties go to the first sample in scan order
+        const int *above = lines[(j - 2) % 3], *mid = lines[(j - 1) % 3], *below = lines[j % 3];
+        for (int i = 1; i + 1 < cols; i++) {
+            int v = mid[i];
+            if (v < threshold) continue;
+            if (v <= above[i - 1] || v <= above[i] || v <= above[i + 1] || v <= mid[i - 1]) continue;
+            if (v < mid[i + 1] || v < below[i - 1] || v < below[i] || v < below[i + 1]) continue;
+            if (++count >= maxCount) return count;
+        }
+    }
+    return count;
+}
+
+bool boardLikelyPresent(const Mat &gray, Size patternSize) {
+    int needed = max(1, (int)(patternSize.area() * PRESENCE_MIN_CORNER_FRACTION));
+    return countBoardCornerCandidates(gray, needed) >= needed;
+}
@@ -0,0 +1,43 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Presence Check (prefilter for board detection)
+ ---------------------------------------------------------
+ * findChessboardCorners is at its slowest when there is no board at all: the
+ * adaptive-threshold search tries every dilation before giving up. The live
+ * loops run it without CALIB_CB_FAST_CHECK, so an empty view costs the most.
+ *
+ * This check looks for the board's inner corners (X-junctions) on a small
+ * image, one pyramid level below the detection level. Every second pixel
+ * gets a ChESS-style response from a 16-sample ring of radius
+ * PRESENCE_RING_RADIUS: opposite samples of a checker corner match and
+ * samples 90 degrees apart differ, while edges and blobs score low. Strong
+ * responses that are local maxima count as corner candidates; below
+ * PRESENCE_MIN_CORNER_FRACTION of the pattern's corners, the frame has no
+ * board and the full detector is skipped.
+ *
+ * The check needs squares of about 4 px at its level, i.e. 8 px at the
+ * detection level, which is roughly where findChessboardCorners stops
+ * finding boards anyway. kernel_benchmark times it (board_presence) and
+ * measures its false-negative rate on rendered boards (--presence-check).
+ */
+
+#ifndef BOARD_PRESENCE_H
+#define BOARD_PRESENCE_H
+
+#include <opencv2/opencv.hpp>
+#include <climits>
+
+const int PRESENCE_RING_RADIUS = 3;
+const int PRESENCE_MIN_CONTRAST = 16;              // Gray levels between dark and light squares
+const double PRESENCE_MIN_CORNER_FRACTION = 0.35;  // Of the pattern's inner corners
+
+// False when the 8-bit gray image clearly shows no board of this pattern
+bool boardLikelyPresent(const cv::Mat &gray, cv::Size patternSize);
+
+// Corner candidates found, stopping early once maxCount is reached
+int countBoardCornerCandidates(const cv::Mat &gray, int maxCount = INT_MAX);
+
+#endif // BOARD_PRESENCE_H
@@ -0,0 +1,266 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Board Subpixel Refinement
+ ---------------------------------------------------------
+ * See board_subpix.h.
+ */
+
+#include "board_subpix.h"
+#include "alloc_counter.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+// Rows are padded to a multiple of the widest fixed-size SIMD register (16
+// floats), so the window loop needs no scalar tail
+const int ROW_PAD = 16;
+
+// Per-thread working set, grown as needed and reused between frames
+struct SubpixBuffers {
+    Mat gradX, gradY;             // Gradient method, ROW_PAD extra columns
+    Mat smooth;                   // Saddle method
+    vector<float> mask, offsets;  // Window weights and x offsets, rows padded
+    vector<Point2f> fallback;
+    vector<int> fallbackIndex;
+};
+
+static SubpixBuffers &buffers() {
+    thread_local SubpixBuffers b;
+    return b;
+}
+
+// rows x cols view of a float buffer that only grows
+static Mat bufferView(Mat &buffer, int rows, int cols) {
+    if (buffer.rows < rows || buffer.cols < cols) {
+        buffer.create(max(buffer.rows, rows), max(buffer.cols, cols), CV_32F);
+    }
+    return buffer(Rect(0, 0, cols, rows));
+}
+
+// Board bounding box grown by margin, clipped to the image
+static Rect boardRegion(const vector<Point2f> &corners, Size imageSize, int marginX, int marginY) {
+    Rect box = boundingRect(corners);
+    box = Rect(box.x - marginX, box.y - marginY, box.width + 2 * marginX, box.height + 2 * marginY);
+    return box & Rect(0, 0, imageSize.width, imageSize.height);
+}
+
+// Weighted structure tensor of one window and its right-hand side, as in
+// cornerSubPix: a = sum w gx^2, b = sum w gx gy, c = sum w gy^2,
+// bx = sum w (gx^2 px + gx gy py), by = sum w (gx gy px + gy^2 py)
+struct TensorSums {
+    double a, b, c, bx, by;
+};
+
+static TensorSums accumulateTensor(const Mat &gx, const Mat &gy, int x0, int y0, int rows, int stride,
+                                   const float *mask, const float *offsets, int halfHeight) {
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    // Scalable vectors may be wider than the row padding: scalar path then
+    const int lanes = VTraits<v_float32>::vlanes();
+    if (ROW_PAD % lanes == 0) {
+        v_float32 sa = vx_setzero_f32(), sb = vx_setzero_f32(), sc = vx_setzero_f32();
+        v_float32 sxx = vx_setzero_f32(), sxy = vx_setzero_f32(), syx = vx_setzero_f32(), syy = vx_setzero_f32();
+        for (int i = 0; i < rows; i++) {
+            const float *gxRow = gx.ptr<float>(y0 + i) + x0;
+            const float *gyRow = gy.ptr<float>(y0 + i) + x0;
+            const float *w = mask + i * stride;
+            v_float32 py = vx_setall_f32((float)(i - halfHeight));
+            for (int j = 0; j < stride; j += lanes) {
+                v_float32 tx = vx_load(gxRow + j), ty = vx_load(gyRow + j), tw = vx_load(w + j);
+                v_float32 wx = v_mul(tw, tx), px = vx_load(offsets + j);
+                v_float32 wxx = v_mul(wx, tx), wxy = v_mul(wx, ty), wyy = v_mul(v_mul(tw, ty), ty);
+                sa = v_add(sa, wxx);
+                sb = v_add(sb, wxy);
+                sc = v_add(sc, wyy);
+                sxx = v_muladd(wxx, px, sxx);
+                sxy = v_muladd(wxy, py, sxy);
+                syx = v_muladd(wxy, px, syx);
+                syy = v_muladd(wyy, py, syy);
+            }
+        }
+        return {v_reduce_sum(sa), v_reduce_sum(sb), v_reduce_sum(sc),
+                (double)v_reduce_sum(sxx) + v_reduce_sum(sxy), (double)v_reduce_sum(syx) + v_reduce_sum(syy)};
+    }
+#endif
+    float sa = 0, sb = 0, sc = 0, sxx = 0, sxy = 0, syx = 0, syy = 0;
+    for (int i = 0; i < rows; i++) {
+        const float *gxRow = gx.ptr<float>(y0 + i) + x0;
+        const float *gyRow = gy.ptr<float>(y0 + i) + x0;
+        const float *w = mask + i * stride;
+        float py = (float)(i - halfHeight);
+        for (int j = 0; j < stride; j++) {
+            float wx = w[j] * gxRow[j];
+            float wxx = wx * gxRow[j], wxy = wx * gyRow[j], wyy = w[j] * gyRow[j] * gyRow[j];
+            sa += wxx;
+            sb += wxy;
+            sc += wyy;
+            sxx += wxx * offsets[j];
+            sxy += wxy * py;
+            syx += wxy * offsets[j];
+            syy += wyy * py;
+        }
+    }
+    return {sa, sb, sc, (double)sxx + sxy, (double)syx + syy};
+}
+
+// Returns false when the window leaves the precomputed region
+static bool refineGradient(const Mat &gx, const Mat &gy, Point roiOrigin, Size roiSize, Point2f &pt,
+                           Size halfWin, int maxIter, double eps2, const SubpixBuffers &b, int stride) {
+    const int hw = halfWin.width, hh = halfWin.height;
+    Point2f q = pt;
+    for (int iter = 0; iter < maxIter; iter++) {
+        // Window on the nearest pixel; gradients there are exact, no resampling
+        int cx = cvRound(q.x) - roiOrigin.x, cy = cvRound(q.y) - roiOrigin.y;
+        if (cx - hw < 0 || cy - hh < 0 || cx + hw >= roiSize.width || cy + hh >= roiSize.height) return false;
+
+        TensorSums s = accumulateTensor(gx, gy, cx - hw, cy - hh, 2 * hh + 1, stride,
+                                        b.mask.data(), b.offsets.data(), hh);
+        double det = s.a * s.c - s.b * s.b;
+        if (fabs(det) < DBL_EPSILON) break;  // Flat window
+
+        Point2f next((float)(cx + roiOrigin.x + (s.c * s.bx - s.b * s.by) / det),
+                     (float)(cy + roiOrigin.y + (s.a * s.by - s.b * s.bx) / det));
+        double dx = next.x - q.x, dy = next.y - q.y;
+        q = next;
+
+        // Converged, or the window would not move: the next pass is identical
+        if (dx * dx + dy * dy <= eps2) break;
+        if (cvRound(q.x) - roiOrigin.x == cx && cvRound(q.y) - roiOrigin.y == cy) break;
+    }
+    pt = q;
+    return true;
+}
+
+// Least-squares quadratic fit over the saddle window as six filters (one per
+// coefficient of a x^2 + b xy + c y^2 + d x + e y + f), rows of pinv(A)
+static const Mat &saddleFilters() {
+    static const Mat filters = []() {
+        const int r = SADDLE_RADIUS, n = (2 * r + 1) * (2 * r + 1);
+        Mat A(n, 6, CV_64F);
+        for (int y = -r, k = 0; y <= r; y++) {
+            for (int x = -r; x <= r; x++, k++) {
+                double row[6] = {(double)x * x, (double)x * y, (double)y * y, (double)x, (double)y, 1.0};
+                for (int c = 0; c < 6; c++) A.at<double>(k, c) = row[c];
+            }
+        }
+        Mat P;
+        invert(A, P, DECOMP_SVD);
+        return P;
+    }();
+    return filters;
+}
+
+// Returns false when the window leaves the region or the fit is no saddle
+static bool refineSaddle(const Mat &smooth, Point roiOrigin, Point2f &pt) {
+    const int r = SADDLE_RADIUS;
+    const Mat &P = saddleFilters();
+    Point2f q = pt;
+    for (int iter = 0; iter < SADDLE_MAX_ITER; iter++) {
+        int cx = cvRound(q.x) - roiOrigin.x, cy = cvRound(q.y) - roiOrigin.y;
+        if (cx - r < 0 || cy - r < 0 || cx + r >= smooth.cols || cy + r >= smooth.rows) return false;
+
+        double k[6] = {0, 0, 0, 0, 0, 0};
+        for (int y = -r, i = 0; y <= r; y++) {
+            const float *row = smooth.ptr<float>(cy + y) + cx;
+            for (int x = -r; x <= r; x++, i++) {
+                for (int c = 0; c < 6; c++) k[c] += P.at<double>(c, i) * row[x];
+            }
+        }
+
+        // Gradient of the fit is zero where [2a b; b 2c] s = -[d e]
+        double det = 4 * k[0] * k[2] - k[1] * k[1];
+        if (det >= 0) return false;  // Extremum or degenerate, not a saddle
+        double sx = (-2 * k[2] * k[3] + k[1] * k[4]) / det;
+        double sy = (-2 * k[0] * k[4] + k[1] * k[3]) / det;
+
+        q = Point2f((float)(cx + roiOrigin.x + sx), (float)(cy + roiOrigin.y + sy));
+        if (fabs(sx) <= 0.5 && fabs(sy) <= 0.5) break;  // Centred on the nearest pixel
+    }
+    pt = q;
+    return true;
+}
+
+void refineBoardCorners(const Mat &gray, vector<Point2f> &corners, Size halfWin,
+                        const TermCriteria &criteria, SubpixMethod method) {
+    CV_Assert(gray.type() == CV_8UC1 && halfWin.width > 0 && halfWin.height > 0);
+    if (corners.empty()) return;
+
+    SubpixBuffers &b = buffers();
+    b.fallback.clear();
+    b.fallbackIndex.clear();
+    const int hw = halfWin.width, hh = halfWin.height;
+
+    if (method == SubpixMethod::Gradient) {
+        int maxIter = (criteria.type & TermCriteria::COUNT) ? max(criteria.maxCount, 1) : 100;
+        double eps = (criteria.type & TermCriteria::EPS) ? max(criteria.epsilon, 0.0) : 0.0;
+
+        // Corners may move up to the half window, and their window reaches as far again
+        Rect roi = boardRegion(corners, gray.size(), 2 * hw + 1, 2 * hh + 1);
+        Mat gx = bufferView(b.gradX, roi.height, roi.width + ROW_PAD);
+        Mat gy = bufferView(b.gradY, roi.height, roi.width + ROW_PAD);
+        Mat gxRoi = gx(Rect(0, 0, roi.width, roi.height)), gyRoi = gy(Rect(0, 0, roi.width, roi.height));
+
+        // Central differences, as cornerSubPix uses; padding columns weigh zero
+        Sobel(gray(roi), gxRoi, CV_32F, 1, 0, 1);
+        Sobel(gray(roi), gyRoi, CV_32F, 0, 1, 1);
+        gx(Rect(roi.width, 0, ROW_PAD, roi.height)).setTo(0);
+        gy(Rect(roi.width, 0, ROW_PAD, roi.height)).setTo(0);
+
+        // cornerSubPix's Gaussian window weights
+        int stride = alignSize(2 * hw + 1, ROW_PAD);
+        b.mask.assign((size_t)(2 * hh + 1) * stride, 0.0f);
+        b.offsets.assign(stride, 0.0f);
+        for (int j = 0; j <= 2 * hw; j++) b.offsets[j] = (float)(j - hw);
+        for (int i = 0; i <= 2 * hh; i++) {
+            double y = (double)(i - hh) / hh;
+            for (int j = 0; j <= 2 * hw; j++) {
+                double x = (double)(j - hw) / hw;
+                b.mask[i * stride + j] = (float)exp(-x * x - y * y);
+            }
+        }
+
+        for (size_t i = 0; i < corners.size(); i++) {
+            Point2f pt = corners[i];
+            if (!refineGradient(gx, gy, roi.tl(), roi.size(), pt, halfWin, maxIter, eps * eps, b, stride)) {
+                b.fallback.push_back(corners[i]);
+                b.fallbackIndex.push_back((int)i);
+                continue;
+            }
+            // Like cornerSubPix, a corner that ran off keeps its start
+            if (fabs(pt.x - corners[i].x) <= hw && fabs(pt.y - corners[i].y) <= hh) corners[i] = pt;
+        }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        vx_cleanup();
+#endif
+    } else {
+        const int margin = hw + SADDLE_RADIUS + 1;
+        Rect roi = boardRegion(corners, gray.size(), margin, margin);
+        Mat smooth = bufferView(b.smooth, roi.height, roi.width);
+        gray(roi).convertTo(smooth, CV_32F);
+        // Isolated: the buffer beyond the view holds stale data
+        GaussianBlur(smooth, smooth, Size(0, 0), SADDLE_SIGMA, 0, BORDER_REFLECT_101 | BORDER_ISOLATED);
+
+        for (size_t i = 0; i < corners.size(); i++) {
+            Point2f pt = corners[i];
+            if (!refineSaddle(smooth, roi.tl(), pt)) {
+                b.fallback.push_back(corners[i]);
+                b.fallbackIndex.push_back((int)i);
+                continue;
+            }
+            if (fabs(pt.x - corners[i].x) <= hw && fabs(pt.y - corners[i].y) <= hh) corners[i] = pt;
+        }
+    }
+
+    // Border corners and failed fits
+    if (!b.fallback.empty()) {
+        AllocationScope scope("cornerSubPix");
+        cornerSubPix(gray, b.fallback, halfWin, Size(-1, -1), criteria);
+        for (size_t k = 0; k < b.fallback.size(); k++) corners[b.fallbackIndex[k]] = b.fallback[k];
+    }
+}
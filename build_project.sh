@@ -0,0 +1,10 @@
+#!/bin/sh
+# Configure and build all tools into bin/.
+# Extra arguments go to CMake, e.g. ./build_project.sh -DENABLE_NATIVE=ON -DENABLE_LTO=ON
+set -e
+
+cd "$(dirname "$0")"
+cmake -S . -B build -DCMAKE_BUILD_TYPE=Release "$@"
+cmake --build build -j"$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)"
+
+echo "Executables are in bin/"
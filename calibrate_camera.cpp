@@ -15,6 +15,8 @@
 */
 
 #include <opencv2/opencv.hpp>
+#include "intrinsics_store.h"
+#include "board_detection.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -105,8 +107,7 @@ int main() {
                 cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE | cv::CALIB_CB_FAST_CHECK);
 
             if (found) {
-                cv::cornerSubPix(gray, corners, cv::Size(11,11), cv::Size(-1,-1),
-                                 cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.001));
+                cv::cornerSubPix(gray, corners, BOARD_SUBPIX_WINDOW, cv::Size(-1, -1), CALIBRATION_SUBPIX_CRITERIA);
                 corner_list.push_back(corners);
                 point_list.push_back(single_objp);
 
@@ -228,6 +229,17 @@ int main() {
     fsw.release();
 
     std::cout << "\nSaved calibration to: " << output_file << "\n";
+
+    // --- Index in the shared intrinsics store (calibration frames come from camera 0) ---
+    CameraIntrinsics intrinsics;
+    intrinsics.cameraId = DEFAULT_CAMERA_ID;
+    intrinsics.imageSize = cv::Size(img_w, img_h);
+    intrinsics.cameraMatrix = cameraMatrix;
+    intrinsics.distCoeffs = distCoeffs;
+    intrinsics.reprojectionError = mean_rmse;
+    if (upsertIntrinsics(DEFAULT_INTRINSICS_STORE, intrinsics)) {
+        std::cout << "Added " << intrinsics.cameraId << " to: " << DEFAULT_INTRINSICS_STORE << "\n";
+    }
     std::cout << "Done.\n";
     return 0;
 }
@@ -9,13 +9,47 @@
  * intrinsic parameters, distortion coefficients, and reprojection errors.
  * 
  * Controls: SPACE=Capture, N=Next camera, R=Reset, ESC=Finish
+ *
+ * Usage: camera_comparison              (one camera after another)
+ *        camera_comparison --concurrent (all cameras at once, timestamp-synchronized)
+ *        camera_comparison --record <dir>   (also save captured views as <dir>/camera_<n>/view_<k>.png,
+ *                                            sync_<k>.png for synchronized views;
+ *                                            a camera's folder is emptied when its capture starts or is reset)
+ *        camera_comparison --from-dir <dir> (offline: calibrate from recorded views, no cameras)
+ *        camera_comparison ... --stereo <a> <b>  (also stereo-calibrate cameras a and b)
+ *        camera_comparison --rectify-bench <stereo_a_b.yml>  (remap throughput at 720p/1080p)
+ *        camera_comparison ... --dev-root <dir>  (enumerate video nodes under dir instead of /dev)
+ *
+ * Stereo mode uses the views both cameras saw in the same synchronized
+ * capture (--concurrent, or sync_<k> views with --from-dir), runs
+ * stereoCalibrate and stereoRectify, and caches fixed-point (CV_16SC2 +
+ * interpolation table) rectification maps per resolution. The cache records
+ * a hash of the calibration and is rebuilt after recalibrating.
+ *
+ * Calibration of all cameras runs on a thread pool after capture, so the
+ * total solve time is bounded by the slowest camera.
  */
 
 #include <opencv2/opencv.hpp>
+#include "intrinsics_store.h"
+#include "camera_inventory.h"
+#include "board_detection.h"
+#include "frame_recording.h"
 #include <iostream>
 #include <vector>
 #include <iomanip>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <chrono>
+#include <memory>
+#include <climits>
+#include <sstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
 
 using namespace cv;
 using namespace std;
@@ -24,6 +58,35 @@ const Size CHECKERBOARD_SIZE(9, 6);
 const float SQUARE_SIZE = 25.0f;
 const int MIN_IMAGES = 10;
 const int TARGET_IMAGES = 15;
+const double SYNC_TOLERANCE_MS = 20.0;  // Max timestamp spread within a synchronized set
+const size_t FRAME_HISTORY = 8;         // Frames kept per camera for pairing
+
+string recordRoot;  // When set, captured views are also written to disk
+
+// Stereo extrinsics and rectification of one camera pair
+struct StereoRig {
+    int leftIndex = -1;
+    int rightIndex = -1;
+    Size imageSize;
+    Mat K1, D1, K2, D2;    // Intrinsics of both cameras
+    Mat R, T;              // Right camera relative to left
+    Mat R1, R2, P1, P2, Q; // Rectification
+    double rms = 0.0;
+    int numViews = 0;
+};
+
+// Fixed-point rectification maps: map1 is CV_16SC2 integer coordinates,
+// map2 is the CV_16UC1 index into OpenCV's interpolation table
+struct RectifyMaps {
+    Size size;
+    Mat map1L, map2L, map1R, map2R;
+};
+
+// View id of a view captured by one camera on its own (sequential mode); only
+// views with the same non-negative id were captured together
+const int UNSYNCHRONIZED_VIEW = -1;
+
+const char RECTIFY_MAGIC[8] = {'R', 'E', 'C', 'T', 'M', 'A', 'P', '2'};
 
 struct CameraCalibration {
     int cameraIndex;
@@ -36,45 +99,125 @@ struct CameraCalibration {
     Size imageSize;
     vector<vector<Point2f>> allImagePoints;
     vector<vector<Point3f>> allObjectPoints;
+    vector<int> viewIds;  // Synchronized capture id of each view, UNSYNCHRONIZED_VIEW if taken alone
 };
 
-// Generate 3D object points for checkerboard
-vector<Point3f> generateObjectPoints() {
-    vector<Point3f> objectPoints;
-    for (int i = 0; i < CHECKERBOARD_SIZE.height; i++) {
-        for (int j = 0; j < CHECKERBOARD_SIZE.width; j++) {
-            objectPoints.push_back(Point3f(j * SQUARE_SIZE, i * SQUARE_SIZE, 0));
+// Frame with the time it was grabbed
+struct TimedFrame {
+    Mat frame;
+    int64 timestampUs = 0;
+};
+
+// Grabs frames from one camera on its own thread and keeps a short
+// timestamped history so frames can be paired across cameras. Uses
+// VideoCapture directly: pairing needs the time of grab(), before decoding,
+// which FrameSource does not expose
+class CameraGrabber {
+public:
+    ~CameraGrabber() { stop(); }
+    
+    bool open(int index) {
+        cameraIndex = index;
+        if (!cap.open(index)) return false;
+        cap.set(CAP_PROP_FRAME_WIDTH, 640);
+        cap.set(CAP_PROP_FRAME_HEIGHT, 480);
+        return true;
+    }
+    
+    void start() {
+        running = true;
+        worker = thread(&CameraGrabber::run, this);
+    }
+    
+    void stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+        cap.release();
+    }
+    
+    int index() const { return cameraIndex; }
+    
+    // Timestamp of the newest frame, or -1 before the first frame arrives
+    int64 latestTimestamp() const {
+        lock_guard<mutex> lock(historyMutex);
+        return history.empty() ? -1 : history.back().timestampUs;
+    }
+    
+    // Frame whose timestamp is closest to timestampUs
+    bool frameNear(int64 timestampUs, TimedFrame &out) const {
+        lock_guard<mutex> lock(historyMutex);
+        if (history.empty()) return false;
+        const TimedFrame *best = &history.front();
+        for (const auto &f : history) {
+            if (llabs(f.timestampUs - timestampUs) < llabs(best->timestampUs - timestampUs)) best = &f;
         }
+        out = *best;
+        return true;
     }
-    return objectPoints;
-}
-
-// Detect available cameras
-vector<int> detectCameras() {
-    vector<int> availableCameras;
     
-    cout << "Detecting cameras..." << endl;
-    for (int i = 0; i < 5; i++) {
-        VideoCapture cap(i);
-        if (cap.isOpened()) {
-            // Try to read a frame to verify camera works
-            Mat frame;
-            cap >> frame;
-            if (!frame.empty()) {
-                availableCameras.push_back(i);
-                cout << "  Camera " << i << " detected" << endl;
+private:
+    void run() {
+        while (running) {
+            // Timestamp at grab time, decode afterwards
+            if (!cap.grab()) {
+                this_thread::sleep_for(chrono::milliseconds(5));
+                continue;
             }
-            cap.release();
+            int64 stamp = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count();
+            TimedFrame f;
+            if (!cap.retrieve(f.frame) || f.frame.empty()) continue;
+            f.timestampUs = stamp;
+            
+            lock_guard<mutex> lock(historyMutex);
+            history.push_back(f);
+            if (history.size() > FRAME_HISTORY) history.pop_front();
         }
     }
     
-    return availableCameras;
+    int cameraIndex = -1;
+    VideoCapture cap;
+    thread worker;
+    atomic<bool> running{false};
+    mutable mutex historyMutex;
+    deque<TimedFrame> history;
+};
+
+// Generate 3D object points for checkerboard
+vector<Point3f> generateObjectPoints() {
+    return boardObjectPoints(CHECKERBOARD_SIZE, SQUARE_SIZE);
+}
+
+// Save a captured view as <recordRoot>/camera_<n>/view_<k>.png, or
+// sync_<k>.png for synchronized view k, so --from-dir can tell them apart
+void recordView(int cameraIndex, int number, bool synchronized, const Mat &frame) {
+    if (recordRoot.empty()) return;
+    filesystem::path dir = filesystem::path(recordRoot) / ("camera_" + to_string(cameraIndex));
+    filesystem::create_directories(dir);
+    string name = (synchronized ? "sync_" : "view_") + to_string(number) + ".png";
+    imwrite((dir / name).string(), frame);
+}
+
+// Remove a camera's recorded views, so a new capture session (or a reset)
+// does not leave stale views for --from-dir to pick up
+void clearRecordedViews(int cameraIndex) {
+    if (recordRoot.empty()) return;
+    error_code ec;
+    filesystem::remove_all(filesystem::path(recordRoot) / ("camera_" + to_string(cameraIndex)), ec);
+    if (ec) cerr << "Warning: could not clear recorded views of camera " << cameraIndex << ": " << ec.message() << endl;
+}
+
+// Detect available cameras
+// Capture nodes are found from their V4L2 capabilities, without streaming
+vector<int> detectCameras(const string& deviceRoot) {
+    cout << "Detecting cameras..." << endl;
+    return availableCameraIndices(deviceRoot);
 }
 
 // Capture calibration images for a camera
 bool captureCalibrationImages(int cameraIndex, CameraCalibration& calib) {
-    VideoCapture cap(cameraIndex);
-    if (!cap.isOpened()) {
+    FrameSource cap;
+    if (!cap.openCamera(cameraIndex)) {
         cerr << "ERROR: Could not open camera " << cameraIndex << endl;
         return false;
     }
@@ -94,8 +237,13 @@ bool captureCalibrationImages(int cameraIndex, CameraCalibration& calib) {
     calib.cameraIndex = cameraIndex;
     calib.allImagePoints.clear();
     calib.allObjectPoints.clear();
+    calib.viewIds.clear();
+    clearRecordedViews(cameraIndex);
     
-    Mat frame;
+    // Frame buffers and corners are reused for every frame
+    Mat frame, display, gray, flash;
+    FramePyramid pyramid;  // For the board presence check
+    vector<Point2f> corners;
     int capturedCount = 0;
     
     while (true) {
@@ -106,18 +254,17 @@ bool captureCalibrationImages(int cameraIndex, CameraCalibration& calib) {
         }
         
         calib.imageSize = frame.size();
-        Mat display = frame.clone();
-        Mat gray;
+        frame.copyTo(display);
         cvtColor(frame, gray, COLOR_BGR2GRAY);
         
-        // Detect checkerboard
-        vector<Point2f> corners;
-        bool found = findChessboardCorners(gray, CHECKERBOARD_SIZE, corners,
-                                          CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
+        // Detect checkerboard; frames without one skip the full search
+        pyramid.reset(gray);
+        bool found = boardLikelyPresent(pyramid, CHECKERBOARD_SIZE, 0) &&
+                     findChessboardCorners(gray, CHECKERBOARD_SIZE, corners,
+                                           CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
         
         if (found) {
-            cornerSubPix(gray, corners, Size(11, 11), Size(-1, -1),
-                        TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.1));
+            cornerSubPix(gray, corners, BOARD_SUBPIX_WINDOW, Size(-1, -1), CALIBRATION_SUBPIX_CRITERIA);
             drawChessboardCorners(display, CHECKERBOARD_SIZE, corners, found);
             
             putText(display, "Checkerboard detected - Press SPACE to capture",
@@ -156,15 +303,22 @@ bool captureCalibrationImages(int cameraIndex, CameraCalibration& calib) {
             cout << "Resetting calibration..." << endl;
             calib.allImagePoints.clear();
             calib.allObjectPoints.clear();
+            calib.viewIds.clear();
+            clearRecordedViews(cameraIndex);
             capturedCount = 0;
         } else if (key == ' ' && found) {
             calib.allImagePoints.push_back(corners);
             calib.allObjectPoints.push_back(objectPoints);
+            calib.viewIds.push_back(UNSYNCHRONIZED_VIEW);
+            recordView(cameraIndex, capturedCount, false, frame);
             capturedCount++;
             cout << "Image " << capturedCount << " captured" << endl;
             
-            // Visual feedback
-            Mat flash = Mat::ones(frame.size(), frame.type()) * 255;
+            // Visual feedback; the white frame is only rebuilt if the size changes
+            if (flash.size() != frame.size() || flash.type() != frame.type()) {
+                flash.create(frame.size(), frame.type());
+                flash.setTo(Scalar::all(255));
+            }
             imshow("Camera " + to_string(cameraIndex) + " Calibration", flash);
             waitKey(100);
             
@@ -186,9 +340,160 @@ bool captureCalibrationImages(int cameraIndex, CameraCalibration& calib) {
     return true;
 }
 
-// Perform calibration
-bool performCalibration(CameraCalibration& calib) {
-    cout << "\nPerforming calibration for camera " << calib.cameraIndex << "..." << endl;
+// Capture calibration views from all cameras at once. Every camera grabs on
+// its own thread; frames are paired by timestamp and the board is searched
+// in all cameras of a synchronized set in parallel.
+vector<CameraCalibration> captureConcurrent(const vector<int> &cameraIndices) {
+    vector<unique_ptr<CameraGrabber>> grabbers;
+    for (int index : cameraIndices) {
+        auto grabber = make_unique<CameraGrabber>();
+        if (!grabber->open(index)) {
+            cerr << "ERROR: Could not open camera " << index << endl;
+            continue;
+        }
+        grabbers.push_back(std::move(grabber));
+    }
+    
+    const size_t n = grabbers.size();
+    vector<CameraCalibration> calibs(n);
+    if (n == 0) return calibs;
+    
+    for (size_t c = 0; c < n; c++) {
+        calibs[c].cameraIndex = grabbers[c]->index();
+        calibs[c].numImages = 0;
+        clearRecordedViews(calibs[c].cameraIndex);
+        grabbers[c]->start();
+    }
+    
+    cout << "\n=== Calibrating " << n << " cameras concurrently ===" << endl;
+    cout << "Target: " << TARGET_IMAGES << " images per camera (minimum: " << MIN_IMAGES << ")" << endl;
+    cout << "\nControls:" << endl;
+    cout << "  SPACE: Capture a synchronized view on every camera that sees the board" << endl;
+    cout << "  R: Reset and start over" << endl;
+    cout << "  N: Finish (once any camera reached the minimum)" << endl;
+    cout << "  ESC: Abort\n" << endl;
+    
+    vector<Point3f> objectPoints = generateObjectPoints();
+    vector<TimedFrame> synced(n);
+    vector<vector<Point2f>> corners(n);
+    vector<uchar> found(n);
+    vector<FramePyramid> pyramids(n);  // For the board presence check
+    int viewId = 0;
+    bool aborted = false;
+    
+    while (true) {
+        // Reference time: the newest moment that every camera has reached
+        int64 refTime = LLONG_MAX;
+        for (const auto &g : grabbers) refTime = min(refTime, g->latestTimestamp());
+        if (refTime < 0) {
+            if (waitKey(5) == 27) {
+                aborted = true;
+                break;
+            }
+            continue;
+        }
+        
+        int64 spreadUs = 0;
+        for (size_t c = 0; c < n; c++) {
+            grabbers[c]->frameNear(refTime, synced[c]);
+            spreadUs = max(spreadUs, llabs(synced[c].timestampUs - refTime));
+        }
+        bool inSync = spreadUs <= SYNC_TOLERANCE_MS * 1000.0;
+        
+        // Board detection per camera in parallel
+        parallel_for_(Range(0, (int)n), [&](const Range &range) {
+            for (int c = range.start; c < range.end; c++) {
+                Mat gray;
+                cvtColor(synced[c].frame, gray, COLOR_BGR2GRAY);
+                pyramids[c].reset(gray);
+                found[c] = boardLikelyPresent(pyramids[c], CHECKERBOARD_SIZE, 0) &&
+                           findChessboardCorners(gray, CHECKERBOARD_SIZE, corners[c],
+                                                 CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
+                if (found[c]) {
+                    cornerSubPix(gray, corners[c], BOARD_SUBPIX_WINDOW, Size(-1, -1), CALIBRATION_SUBPIX_CRITERIA);
+                }
+            }
+        });
+        
+        // Mosaic of all cameras
+        vector<Mat> tiles(n);
+        for (size_t c = 0; c < n; c++) {
+            Mat display = synced[c].frame.clone();
+            calibs[c].imageSize = display.size();
+            if (found[c]) drawChessboardCorners(display, CHECKERBOARD_SIZE, corners[c], true);
+            string label = "Camera " + to_string(calibs[c].cameraIndex) + ": " +
+                           to_string(calibs[c].allImagePoints.size()) + "/" + to_string(TARGET_IMAGES);
+            putText(display, label, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.7,
+                    found[c] ? Scalar(0, 255, 0) : Scalar(0, 0, 255), 2);
+            resize(display, tiles[c], Size(480, 360));
+        }
+        Mat mosaic;
+        hconcat(tiles, mosaic);
+        string syncInfo = "Sync spread: " + to_string((int)(spreadUs / 1000)) + " ms" +
+                          (inSync ? "" : " (waiting)");
+        putText(mosaic, syncInfo, Point(10, mosaic.rows - 10), FONT_HERSHEY_SIMPLEX, 0.6,
+                inSync ? Scalar(255, 255, 0) : Scalar(0, 0, 255), 2);
+        imshow("Concurrent Calibration", mosaic);
+        
+        int key = waitKey(1);
+        if (key == 27) {
+            aborted = true;
+            break;
+        } else if (key == 'n' || key == 'N') {
+            bool anyReady = false;
+            for (const auto &calib : calibs) anyReady |= (int)calib.allImagePoints.size() >= MIN_IMAGES;
+            if (anyReady) break;
+            cout << "Need at least " << MIN_IMAGES << " images on one camera!" << endl;
+        } else if (key == 'r' || key == 'R') {
+            cout << "Resetting calibration..." << endl;
+            for (auto &calib : calibs) {
+                calib.allImagePoints.clear();
+                calib.allObjectPoints.clear();
+                calib.viewIds.clear();
+                clearRecordedViews(calib.cameraIndex);
+            }
+            viewId = 0;
+        } else if (key == ' ') {
+            if (!inSync) {
+                cout << "Frames not synchronized, try again" << endl;
+                continue;
+            }
+            int stored = 0;
+            for (size_t c = 0; c < n; c++) {
+                if (!found[c]) continue;
+                calibs[c].allImagePoints.push_back(corners[c]);
+                calibs[c].allObjectPoints.push_back(objectPoints);
+                calibs[c].viewIds.push_back(viewId);
+                recordView(calibs[c].cameraIndex, viewId, true, synced[c].frame);
+                stored++;
+            }
+            if (stored > 0) {
+                cout << "View " << viewId << " captured on " << stored << "/" << n << " cameras" << endl;
+                viewId++;
+            }
+        }
+    }
+    
+    for (auto &g : grabbers) g->stop();
+    destroyAllWindows();
+    
+    // Keep cameras with enough views
+    vector<CameraCalibration> ready;
+    if (aborted) return ready;
+    for (auto &calib : calibs) {
+        calib.numImages = (int)calib.allImagePoints.size();
+        if (calib.numImages >= MIN_IMAGES) {
+            ready.push_back(calib);
+        } else {
+            cout << "Not enough images captured for camera " << calib.cameraIndex << endl;
+        }
+    }
+    return ready;
+}
+
+// Perform calibration, writing progress to log (thread-safe per camera)
+bool performCalibration(CameraCalibration& calib, ostream &log) {
+    log << "\nPerforming calibration for camera " << calib.cameraIndex << "..." << endl;
     
     calib.cameraMatrix = Mat::eye(3, 3, CV_64F);
     calib.distCoeffs = Mat::zeros(8, 1, CV_64F);
@@ -205,16 +510,126 @@ bool performCalibration(CameraCalibration& calib) {
             CALIB_FIX_K4 | CALIB_FIX_K5
         );
         
-        cout << "✓ Calibration successful!" << endl;
-        cout << "  Reprojection error: " << calib.reprojectionError << " pixels" << endl;
+        log << "✓ Calibration successful!" << endl;
+        log << "  Reprojection error: " << calib.reprojectionError << " pixels" << endl;
         
         return true;
     } catch (const Exception& e) {
-        cerr << "ERROR: Calibration failed: " << e.what() << endl;
+        log << "ERROR: Calibration failed: " << e.what() << endl;
         return false;
     }
 }
 
+// Calibrate all cameras on a thread pool; results keep the input order
+vector<CameraCalibration> calibrateAll(vector<CameraCalibration> &captured) {
+    const size_t n = captured.size();
+    vector<CameraCalibration> calibrated;
+    if (n == 0) return calibrated;
+    
+    size_t numThreads = min(n, (size_t)max(1u, thread::hardware_concurrency()));
+    cout << "\nCalibrating " << n << " camera(s) on " << numThreads << " thread(s)..." << endl;
+    
+    vector<ostringstream> logs(n);
+    vector<char> succeeded(n, 0);
+    atomic<size_t> next(0);
+    
+    int64 start = getTickCount();
+    vector<thread> pool;
+    for (size_t t = 0; t < numThreads; t++) {
+        pool.emplace_back([&] {
+            size_t i;
+            while ((i = next++) < n) {
+                succeeded[i] = performCalibration(captured[i], logs[i]);
+            }
+        });
+    }
+    for (auto &worker : pool) worker.join();
+    double elapsed = (getTickCount() - start) / getTickFrequency();
+    
+    for (size_t i = 0; i < n; i++) {
+        cout << logs[i].str();
+        if (succeeded[i]) calibrated.push_back(captured[i]);
+    }
+    cout << "\nAll calibrations finished in " << fixed << setprecision(2) << elapsed << " s" << endl;
+    return calibrated;
+}
+
+// Load recorded views from <root>/camera_<n>/*.png and detect the board in
+// every image in parallel. View ids are taken from view_<k> file names.
+vector<CameraCalibration> loadRecordedCameras(const string &root) {
+    namespace fs = std::filesystem;
+    vector<CameraCalibration> cameras;
+    if (!fs::is_directory(root)) {
+        cerr << "ERROR: Directory not found: " << root << endl;
+        return cameras;
+    }
+    
+    vector<fs::path> cameraDirs;
+    for (auto &entry : fs::directory_iterator(root)) {
+        if (entry.is_directory()) cameraDirs.push_back(entry.path());
+    }
+    sort(cameraDirs.begin(), cameraDirs.end());
+    
+    vector<Point3f> objectPoints = generateObjectPoints();
+    
+    for (size_t d = 0; d < cameraDirs.size(); d++) {
+        vector<fs::path> files;
+        for (auto &entry : fs::directory_iterator(cameraDirs[d])) {
+            string ext = entry.path().extension().string();
+            for (auto &ch : ext) ch = (char)tolower(ch);
+            if (entry.is_regular_file() && (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp"))
+                files.push_back(entry.path());
+        }
+        sort(files.begin(), files.end());
+        if (files.empty()) continue;
+        
+        // Camera index from a trailing number in the directory name
+        CameraCalibration calib;
+        string dirName = cameraDirs[d].filename().string();
+        size_t digits = dirName.find_last_not_of("0123456789");
+        calib.cameraIndex = (digits + 1 < dirName.size()) ? stoi(dirName.substr(digits + 1)) : (int)d;
+        calib.numImages = 0;
+        
+        vector<vector<Point2f>> corners(files.size());
+        vector<uchar> found(files.size(), 0);
+        vector<Size> sizes(files.size());
+        
+        parallel_for_(Range(0, (int)files.size()), [&](const Range &range) {
+            for (int i = range.start; i < range.end; i++) {
+                Mat gray = imread(files[i].string(), IMREAD_GRAYSCALE);
+                if (gray.empty()) continue;
+                sizes[i] = gray.size();
+                found[i] = findChessboardCorners(gray, CHECKERBOARD_SIZE, corners[i],
+                                                 CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
+                if (found[i]) {
+                    cornerSubPix(gray, corners[i], BOARD_SUBPIX_WINDOW, Size(-1, -1), CALIBRATION_SUBPIX_CRITERIA);
+                }
+            }
+        });
+        
+        for (size_t i = 0; i < files.size(); i++) {
+            if (!found[i]) continue;
+            string stem = files[i].stem().string();
+            // Only sync_<k> views were captured together with other cameras
+            int viewId = (stem.rfind("sync_", 0) == 0) ? atoi(stem.c_str() + 5) : UNSYNCHRONIZED_VIEW;
+            calib.imageSize = sizes[i];
+            calib.allImagePoints.push_back(corners[i]);
+            calib.allObjectPoints.push_back(objectPoints);
+            calib.viewIds.push_back(viewId);
+        }
+        calib.numImages = (int)calib.allImagePoints.size();
+        
+        cout << "  Camera " << calib.cameraIndex << ": board found in " << calib.numImages
+             << "/" << files.size() << " images (" << dirName << ")" << endl;
+        if (calib.numImages >= MIN_IMAGES) {
+            cameras.push_back(calib);
+        } else {
+            cout << "Not enough images for camera " << calib.cameraIndex << endl;
+        }
+    }
+    return cameras;
+}
+
 // Save calibration to file
 void saveCalibration(const CameraCalibration& calib) {
     string filename = "camera_" + to_string(calib.cameraIndex) + "_intrinsics.yml";
@@ -232,6 +647,261 @@ void saveCalibration(const CameraCalibration& calib) {
     fs.release();
     
     cout << "✓ Calibration saved to: " << filename << endl;
+    
+    // Index the camera in the shared store used by the pose/AR tools
+    CameraIntrinsics intrinsics;
+    intrinsics.cameraId = "camera_" + to_string(calib.cameraIndex);
+    intrinsics.imageSize = calib.imageSize;
+    intrinsics.cameraMatrix = calib.cameraMatrix;
+    intrinsics.distCoeffs = calib.distCoeffs;
+    intrinsics.reprojectionError = calib.reprojectionError;
+    if (upsertIntrinsics(DEFAULT_INTRINSICS_STORE, intrinsics)) {
+        cout << "✓ Added " << intrinsics.cameraId << " to: " << DEFAULT_INTRINSICS_STORE << endl;
+    }
+}
+
+// Stereo-calibrate two calibrated cameras from their shared synchronized views
+bool calibrateStereoPair(const CameraCalibration &left, const CameraCalibration &right, StereoRig &rig) {
+    vector<vector<Point3f>> objectPoints;
+    vector<vector<Point2f>> leftPoints, rightPoints;
+    for (size_t i = 0; i < left.viewIds.size(); i++) {
+        if (left.viewIds[i] == UNSYNCHRONIZED_VIEW) continue;
+        auto it = find(right.viewIds.begin(), right.viewIds.end(), left.viewIds[i]);
+        if (it == right.viewIds.end()) continue;
+        size_t j = it - right.viewIds.begin();
+        objectPoints.push_back(left.allObjectPoints[i]);
+        leftPoints.push_back(left.allImagePoints[i]);
+        rightPoints.push_back(right.allImagePoints[j]);
+    }
+    
+    cout << "\nStereo pair " << left.cameraIndex << " / " << right.cameraIndex << ": "
+         << objectPoints.size() << " shared views" << endl;
+    if ((int)objectPoints.size() < MIN_IMAGES / 2) {
+        cerr << "ERROR: Not enough synchronized views for stereo calibration "
+             << "(use --concurrent capture)" << endl;
+        return false;
+    }
+    if (left.imageSize != right.imageSize) {
+        cerr << "ERROR: Stereo cameras must share the same resolution" << endl;
+        return false;
+    }
+    
+    rig.leftIndex = left.cameraIndex;
+    rig.rightIndex = right.cameraIndex;
+    rig.imageSize = left.imageSize;
+    rig.K1 = left.cameraMatrix.clone();
+    rig.D1 = left.distCoeffs.clone();
+    rig.K2 = right.cameraMatrix.clone();
+    rig.D2 = right.distCoeffs.clone();
+    rig.numViews = (int)objectPoints.size();
+    
+    try {
+        Mat E, F;
+        rig.rms = stereoCalibrate(objectPoints, leftPoints, rightPoints,
+                                  rig.K1, rig.D1, rig.K2, rig.D2, rig.imageSize,
+                                  rig.R, rig.T, E, F, CALIB_FIX_INTRINSIC,
+                                  TermCriteria(TermCriteria::COUNT + TermCriteria::EPS, 100, 1e-6));
+        stereoRectify(rig.K1, rig.D1, rig.K2, rig.D2, rig.imageSize, rig.R, rig.T,
+                      rig.R1, rig.R2, rig.P1, rig.P2, rig.Q, CALIB_ZERO_DISPARITY, 0);
+    } catch (const Exception &e) {
+        cerr << "ERROR: Stereo calibration failed: " << e.what() << endl;
+        return false;
+    }
+    
+    cout << "✓ Stereo calibration successful!" << endl;
+    cout << "  RMS error: " << rig.rms << " pixels" << endl;
+    cout << "  Baseline: " << norm(rig.T) << " (board units: mm)" << endl;
+    return true;
+}
+
+string stereoFileBase(const StereoRig &rig) {
+    return "stereo_" + to_string(rig.leftIndex) + "_" + to_string(rig.rightIndex);
+}
+
+void saveStereoRig(const StereoRig &rig) {
+    string filename = stereoFileBase(rig) + ".yml";
+    FileStorage fs(filename, FileStorage::WRITE);
+    fs << "left_camera" << rig.leftIndex;
+    fs << "right_camera" << rig.rightIndex;
+    fs << "image_width" << rig.imageSize.width;
+    fs << "image_height" << rig.imageSize.height;
+    fs << "num_views" << rig.numViews;
+    fs << "rms_error" << rig.rms;
+    fs << "K1" << rig.K1 << "D1" << rig.D1 << "K2" << rig.K2 << "D2" << rig.D2;
+    fs << "R" << rig.R << "T" << rig.T;
+    fs << "R1" << rig.R1 << "R2" << rig.R2 << "P1" << rig.P1 << "P2" << rig.P2 << "Q" << rig.Q;
+    fs.release();
+    cout << "✓ Stereo calibration saved to: " << filename << endl;
+}
+
+bool loadStereoRig(const string &filename, StereoRig &rig) {
+    FileStorage fs(filename, FileStorage::READ);
+    if (!fs.isOpened()) {
+        cerr << "Failed to open stereo parameters file: " << filename << endl;
+        return false;
+    }
+    fs["left_camera"] >> rig.leftIndex;
+    fs["right_camera"] >> rig.rightIndex;
+    fs["image_width"] >> rig.imageSize.width;
+    fs["image_height"] >> rig.imageSize.height;
+    fs["num_views"] >> rig.numViews;
+    fs["rms_error"] >> rig.rms;
+    fs["K1"] >> rig.K1; fs["D1"] >> rig.D1; fs["K2"] >> rig.K2; fs["D2"] >> rig.D2;
+    fs["R"] >> rig.R; fs["T"] >> rig.T;
+    fs["R1"] >> rig.R1; fs["R2"] >> rig.R2; fs["P1"] >> rig.P1; fs["P2"] >> rig.P2; fs["Q"] >> rig.Q;
+    fs.release();
+    return !rig.K1.empty() && !rig.R.empty();
+}
+
+// Rectification for an output size; intrinsics are rescaled when it differs
+// from the calibration resolution
+void buildRectifyMaps(const StereoRig &rig, Size size, RectifyMaps &maps, int mapType = CV_16SC2) {
+    Mat K1 = rig.K1.clone(), K2 = rig.K2.clone();
+    Mat R1 = rig.R1, R2 = rig.R2, P1 = rig.P1, P2 = rig.P2;
+    if (size != rig.imageSize) {
+        double sx = (double)size.width / rig.imageSize.width;
+        double sy = (double)size.height / rig.imageSize.height;
+        for (Mat *K : {&K1, &K2}) {
+            K->at<double>(0, 0) *= sx;  // fx
+            K->at<double>(1, 1) *= sy;  // fy
+            K->at<double>(0, 2) *= sx;  // cx
+            K->at<double>(1, 2) *= sy;  // cy
+        }
+        Mat Q;
+        stereoRectify(K1, rig.D1, K2, rig.D2, size, rig.R, rig.T,
+                      R1, R2, P1, P2, Q, CALIB_ZERO_DISPARITY, 0);
+    }
+    maps.size = size;
+    initUndistortRectifyMap(K1, rig.D1, R1, P1, size, mapType, maps.map1L, maps.map2L);
+    initUndistortRectifyMap(K2, rig.D2, R2, P2, size, mapType, maps.map1R, maps.map2R);
+}
+
+// FNV-1a over the calibration the maps are built from, so cached maps of an
+// older calibration of the same pair are rebuilt
+uint64_t rigParameterHash(const StereoRig &rig) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void *data, size_t bytes) {
+        const uchar *p = (const uchar*)data;
+        for (size_t i = 0; i < bytes; i++) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    int32_t dims[2] = {rig.imageSize.width, rig.imageSize.height};
+    mix(dims, sizeof(dims));
+    for (const Mat *m : {&rig.K1, &rig.D1, &rig.K2, &rig.D2, &rig.R, &rig.T}) {
+        Mat values;  // Newly allocated, so continuous
+        m->convertTo(values, CV_64F);
+        int32_t shape[2] = {m->rows, m->cols};
+        mix(shape, sizeof(shape));
+        if (!values.empty()) mix(values.data, values.total() * values.elemSize());
+    }
+    return hash;
+}
+
+// Raw map dump: magic, size, rig hash, then map1L/map2L/map1R/map2R
+bool saveRectifyMaps(const string &filename, const RectifyMaps &maps, uint64_t rigHash) {
+    ofstream out(filename, ios::binary);
+    if (!out) return false;
+    int32_t dims[2] = {maps.size.width, maps.size.height};
+    out.write(RECTIFY_MAGIC, sizeof(RECTIFY_MAGIC));
+    out.write((const char*)dims, sizeof(dims));
+    out.write((const char*)&rigHash, sizeof(rigHash));
+    for (const Mat *m : {&maps.map1L, &maps.map2L, &maps.map1R, &maps.map2R}) {
+        out.write((const char*)m->data, m->total() * m->elemSize());
+    }
+    return (bool)out;
+}
+
+bool loadRectifyMaps(const string &filename, Size expectedSize, uint64_t rigHash, RectifyMaps &maps) {
+    ifstream in(filename, ios::binary);
+    if (!in) return false;
+    char magic[8];
+    int32_t dims[2];
+    uint64_t storedHash = 0;
+    in.read(magic, sizeof(magic));
+    in.read((char*)dims, sizeof(dims));
+    in.read((char*)&storedHash, sizeof(storedHash));
+    if (!in || memcmp(magic, RECTIFY_MAGIC, sizeof(magic)) != 0 ||
+        Size(dims[0], dims[1]) != expectedSize || storedHash != rigHash) return false;
+    
+    maps.size = expectedSize;
+    maps.map1L.create(expectedSize, CV_16SC2);
+    maps.map2L.create(expectedSize, CV_16UC1);
+    maps.map1R.create(expectedSize, CV_16SC2);
+    maps.map2R.create(expectedSize, CV_16UC1);
+    for (Mat *m : {&maps.map1L, &maps.map2L, &maps.map1R, &maps.map2R}) {
+        in.read((char*)m->data, m->total() * m->elemSize());
+    }
+    return (bool)in;
+}
+
+// Fixed-point maps for a resolution, from the disk cache when it was built
+// from this calibration
+void getRectifyMaps(const StereoRig &rig, Size size, RectifyMaps &maps) {
+    string cacheFile = stereoFileBase(rig) + "_" + to_string(size.width) + "x" +
+                       to_string(size.height) + ".maps";
+    uint64_t rigHash = rigParameterHash(rig);
+    if (loadRectifyMaps(cacheFile, size, rigHash, maps)) return;
+    
+    buildRectifyMaps(rig, size, maps);
+    if (saveRectifyMaps(cacheFile, maps, rigHash)) {
+        cout << "✓ Rectification maps cached to: " << cacheFile << endl;
+    }
+}
+
+// Rectification stage: one remap per image with the precomputed maps
+void rectifyPair(const Mat &left, const Mat &right, const RectifyMaps &maps,
+                 Mat &leftRect, Mat &rightRect) {
+    remap(left, leftRect, maps.map1L, maps.map2L, INTER_LINEAR);
+    remap(right, rightRect, maps.map1R, maps.map2R, INTER_LINEAR);
+}
+
+// Stereo pairs per second through rectifyPair at common stream sizes,
+// fixed-point maps versus float maps
+void benchmarkRectification(const StereoRig &rig) {
+    const int iterations = 200;
+    const vector<Size> sizes = {Size(1280, 720), Size(1920, 1080)};
+    
+    cout << "\n" << string(80, '=') << endl;
+    cout << "STEREO RECTIFICATION THROUGHPUT (" << iterations << " pairs)" << endl;
+    cout << string(80, '=') << endl;
+    cout << left << setw(14) << "Resolution"
+         << setw(16) << "Maps"
+         << setw(16) << "ms / pair"
+         << setw(16) << "Pairs / s"
+         << setw(16) << "Map MB" << endl;
+    cout << string(80, '-') << endl;
+    
+    for (const Size &size : sizes) {
+        Mat leftImg(size, CV_8UC3), rightImg(size, CV_8UC3), leftRect, rightRect;
+        randu(leftImg, Scalar::all(0), Scalar::all(255));
+        randu(rightImg, Scalar::all(0), Scalar::all(255));
+        
+        RectifyMaps fixedMaps, floatMaps;
+        getRectifyMaps(rig, size, fixedMaps);
+        buildRectifyMaps(rig, size, floatMaps, CV_32FC1);
+        
+        for (const RectifyMaps *maps : {&fixedMaps, &floatMaps}) {
+            rectifyPair(leftImg, rightImg, *maps, leftRect, rightRect);  // Warm-up
+            int64 start = getTickCount();
+            for (int i = 0; i < iterations; i++) {
+                rectifyPair(leftImg, rightImg, *maps, leftRect, rightRect);
+            }
+            double ms = (getTickCount() - start) * 1000.0 / getTickFrequency() / iterations;
+            double mapBytes = 0;
+            for (const Mat *m : {&maps->map1L, &maps->map2L, &maps->map1R, &maps->map2R}) {
+                mapBytes += m->total() * m->elemSize();
+            }
+            
+            cout << left << setw(14) << (to_string(size.width) + "x" + to_string(size.height))
+                 << setw(16) << (maps == &fixedMaps ? "CV_16SC2" : "CV_32FC1")
+                 << setw(16) << fixed << setprecision(3) << ms
+                 << setw(16) << setprecision(1) << 1000.0 / ms
+                 << setw(16) << setprecision(1) << mapBytes / (1024.0 * 1024.0) << endl;
+        }
+    }
+    cout << string(80, '=') << endl;
 }
 
 // Generate comparison report
@@ -381,44 +1051,100 @@ void generateComparisonReport(const vector<CameraCalibration>& calibrations) {
     }
 }
 
-int main() {
-    cout << "=== Camera Calibration Comparison Tool ===" << endl;
-    cout << "\nThis tool will calibrate all available cameras and compare them." << endl;
-    
-    // Detect cameras
-    vector<int> cameras = detectCameras();
-    
-    if (cameras.empty()) {
-        cerr << "\nERROR: No cameras detected!" << endl;
-        return -1;
+int main(int argc, char** argv) {
+    bool concurrentMode = false;
+    string fromDir;
+    int stereoLeft = -1, stereoRight = -1;
+    string deviceRoot = DEFAULT_DEVICE_ROOT;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--rectify-bench" && i + 1 < argc) {
+            StereoRig rig;
+            if (!loadStereoRig(argv[++i], rig)) return -1;
+            benchmarkRectification(rig);
+            return 0;
+        } else if (arg == "--stereo" && i + 2 < argc) {
+            stereoLeft = atoi(argv[++i]);
+            stereoRight = atoi(argv[++i]);
+        } else if (arg == "--concurrent") {
+            concurrentMode = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordRoot = argv[++i];
+        } else if (arg == "--from-dir" && i + 1 < argc) {
+            fromDir = argv[++i];
+        } else if (arg == "--dev-root" && i + 1 < argc) {
+            deviceRoot = argv[++i];
+        }
     }
     
-    cout << "\nFound " << cameras.size() << " camera(s)" << endl;
+    cout << "=== Camera Calibration Comparison Tool ===" << endl;
     
-    // Calibrate each camera
-    vector<CameraCalibration> calibrations;
+    vector<CameraCalibration> captured;
     
-    for (int cameraIndex : cameras) {
-        CameraCalibration calib;
+    if (!fromDir.empty()) {
+        // Offline comparison from recorded per-camera frame directories
+        cout << "\nLoading recorded views from " << fromDir << "..." << endl;
+        captured = loadRecordedCameras(fromDir);
+    } else {
+        cout << "\nThis tool will calibrate all available cameras and compare them." << endl;
         
-        if (captureCalibrationImages(cameraIndex, calib)) {
-            if (performCalibration(calib)) {
-                saveCalibration(calib);
-                calibrations.push_back(calib);
-            }
+        // Detect cameras
+        vector<int> cameras = detectCameras(deviceRoot);
+        
+        if (cameras.empty()) {
+            cerr << "\nERROR: No cameras detected!" << endl;
+            return -1;
         }
         
-        cout << "\nPress ENTER to continue to next camera (or ESC to finish)..." << endl;
-        int key = waitKey(0);
-        if (key == 27) {
-            break;
+        cout << "\nFound " << cameras.size() << " camera(s)" << endl;
+        
+        if (concurrentMode) {
+            // One sweep of the board collects views for every camera
+            captured = captureConcurrent(cameras);
+        } else {
+            for (int cameraIndex : cameras) {
+                CameraCalibration calib;
+                if (captureCalibrationImages(cameraIndex, calib)) {
+                    captured.push_back(calib);
+                }
+                
+                cout << "\nPress ENTER to continue to next camera (or ESC to finish)..." << endl;
+                int key = waitKey(0);
+                if (key == 27) {
+                    break;
+                }
+            }
         }
     }
     
+    // Independent solves run in parallel
+    vector<CameraCalibration> calibrations = calibrateAll(captured);
+    for (const auto &calib : calibrations) {
+        saveCalibration(calib);
+    }
+    
     // Generate comparison report
     if (!calibrations.empty()) {
         generateComparisonReport(calibrations);
     }
     
+    // Relate the requested pair and precompute its rectification maps
+    if (stereoLeft >= 0) {
+        const CameraCalibration *left = nullptr, *right = nullptr;
+        for (const auto &calib : calibrations) {
+            if (calib.cameraIndex == stereoLeft) left = &calib;
+            if (calib.cameraIndex == stereoRight) right = &calib;
+        }
+        StereoRig rig;
+        if (!left || !right) {
+            cerr << "\nERROR: Stereo cameras " << stereoLeft << " and " << stereoRight
+                 << " were not both calibrated" << endl;
+        } else if (calibrateStereoPair(*left, *right, rig)) {
+            saveStereoRig(rig);
+            RectifyMaps maps;
+            getRectifyMaps(rig, rig.imageSize, maps);
+        }
+    }
+    
     return 0;
 }
@@ -0,0 +1,218 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Camera Inventory
+ ---------------------------------------------------------
+ * Inventory file: one tab-separated line per device
+ *   path  inode  ctime  queried  canCapture  driver  card  busInfo
+ * An entry is reused while the node's inode and ctime are unchanged
+ * (replugging a camera recreates its node).
+ */
+
+#include "camera_inventory.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/videodev2.h>
+#endif
+
+using namespace cv;
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct InventoryEntry {
+    CameraDevice device;
+    long long inode = 0;
+    long long ctime = 0;
+};
+
+// "video12" -> 12, anything else -> -1
+int videoIndex(const string &name) {
+    if (name.compare(0, 5, "video") != 0 || name.size() == 5) return -1;
+    int index = 0;
+    for (size_t i = 5; i < name.size(); i++) {
+        if (name[i] < '0' || name[i] > '9') return -1;
+        index = index * 10 + (name[i] - '0');
+    }
+    return index;
+}
+
+bool nodeSignature(const string &path, long long &inode, long long &ctime) {
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    inode = (long long)st.st_ino;
+    ctime = (long long)st.st_ctime;
+    return true;
+#else
+    (void)path; inode = 0; ctime = 0;
+    return false;
+#endif
+}
+
+// Capabilities without streaming: open non-blocking, one ioctl, close
+void queryDevice(CameraDevice &device) {
+    device.queried = false;
+    device.canCapture = false;
+#ifdef __linux__
+    int fd = open(device.path.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd < 0) fd = open(device.path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0) return;
+
+    struct v4l2_capability cap;
+    memset(&cap, 0, sizeof(cap));
+    if (ioctl(fd, VIDIOC_QUERYCAP, &cap) == 0) {
+        uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+        device.queried = true;
+        device.canCapture = (caps & (V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_VIDEO_CAPTURE_MPLANE)) != 0;
+        device.driver = string((const char*)cap.driver, strnlen((const char*)cap.driver, sizeof(cap.driver)));
+        device.card = string((const char*)cap.card, strnlen((const char*)cap.card, sizeof(cap.card)));
+        device.busInfo = string((const char*)cap.bus_info, strnlen((const char*)cap.bus_info, sizeof(cap.bus_info)));
+    }
+    close(fd);
+#endif
+}
+
+// Tabs and newlines would break the line format
+string clean(const string &s) {
+    string out = s;
+    replace(out.begin(), out.end(), '\t', ' ');
+    replace(out.begin(), out.end(), '\n', ' ');
+    return out;
+}
+
+map<string, InventoryEntry> readInventory(const string &filename) {
+    map<string, InventoryEntry> entries;
+    ifstream in(filename);
+    string line;
+    while (getline(in, line)) {
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, '\t')) fields.push_back(field);
+        if (fields.size() < 5) continue;
+
+        InventoryEntry e;
+        try {
+            e.device.path = fields[0];
+            e.inode = stoll(fields[1]);
+            e.ctime = stoll(fields[2]);
+            e.device.queried = fields[3] == "1";
+            e.device.canCapture = fields[4] == "1";
+        } catch (const exception &) {
+            continue;
+        }
+        if (fields.size() > 5) e.device.driver = fields[5];
+        if (fields.size() > 6) e.device.card = fields[6];
+        if (fields.size() > 7) e.device.busInfo = fields[7];
+        e.device.index = videoIndex(fs::path(e.device.path).filename().string());
+        entries[e.device.path] = e;
+    }
+    return entries;
+}
+
+void writeInventory(const string &filename, const vector<InventoryEntry> &entries) {
+    ofstream out(filename);
+    if (!out) return;  // A read-only working directory only costs the cache
+    for (const auto &e : entries) {
+        out << clean(e.device.path) << '\t' << e.inode << '\t' << e.ctime << '\t'
+            << (e.device.queried ? 1 : 0) << '\t' << (e.device.canCapture ? 1 : 0) << '\t'
+            << clean(e.device.driver) << '\t' << clean(e.device.card) << '\t'
+            << clean(e.device.busInfo) << '\n';
+    }
+}
+
+} // namespace
+
+vector<CameraDevice> enumerateCameras(const string &root, const string &inventoryFile) {
+    vector<InventoryEntry> found;
+    error_code ec;
+    for (fs::directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        InventoryEntry e;
+        e.device.index = videoIndex(it->path().filename().string());
+        if (e.device.index < 0) continue;
+        e.device.path = it->path().string();
+        nodeSignature(e.device.path, e.inode, e.ctime);
+        found.push_back(e);
+    }
+    if (found.empty()) return {};
+
+    sort(found.begin(), found.end(), [](const InventoryEntry &a, const InventoryEntry &b) {
+        return a.device.index < b.device.index;
+    });
+
+    map<string, InventoryEntry> cached;
+    if (!inventoryFile.empty()) cached = readInventory(inventoryFile);
+
+    bool changed = cached.size() != found.size();
+    for (auto &e : found) {
+        auto hit = cached.find(e.device.path);
+        if (hit != cached.end() && hit->second.inode == e.inode && hit->second.ctime == e.ctime) {
+            e.device = hit->second.device;
+            e.device.index = videoIndex(fs::path(e.device.path).filename().string());
+        } else {
+            queryDevice(e.device);
+            changed = true;
+        }
+    }
+
+    if (changed && !inventoryFile.empty()) writeInventory(inventoryFile, found);
+
+    vector<CameraDevice> devices;
+    devices.reserve(found.size());
+    for (const auto &e : found) devices.push_back(e.device);
+    return devices;
+}
+
+vector<int> availableCameraIndices(const string &root, const string &inventoryFile, bool verbose) {
+    vector<int> indices;
+    vector<CameraDevice> devices = enumerateCameras(root, inventoryFile);
+
+    if (!devices.empty()) {
+        for (const auto &d : devices) {
+            if (d.queried && !d.canCapture) continue;  // Metadata / output nodes
+            indices.push_back(d.index);
+            if (verbose) {
+                cout << "  Camera " << d.index << " - " << d.path;
+                if (!d.card.empty()) cout << " (" << d.card << ")";
+                if (!d.queried) cout << " [unverified]";
+                cout << endl;
+            }
+        }
+        return indices;
+    }
+
+    // No video nodes to inspect: probe capture indices directly
+    for (int i = 0; i < FALLBACK_PROBE_COUNT; i++) {
+        VideoCapture cap(i);
+        if (cap.isOpened()) {
+            indices.push_back(i);
+            if (verbose) cout << "  Camera " << i << " - Available" << endl;
+        }
+    }
+    return indices;
+}
+
+string deviceRootFromArgs(int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--dev-root") return argv[i + 1];
+    }
+    return DEFAULT_DEVICE_ROOT;
+}
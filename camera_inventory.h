@@ -0,0 +1,56 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Camera Inventory (fast camera enumeration)
+ ---------------------------------------------------------
+ * Lists the video<N> nodes under a device root (default /dev) and asks each
+ * one for its capabilities with VIDIOC_QUERYCAP, which answers without
+ * starting a stream. Metadata and output-only nodes are skipped, so no
+ * VideoCapture is opened and no frame is grabbed just to find the cameras.
+ *
+ * Results are cached in an inventory file keyed by device path and checked
+ * against the node's inode / change time, so unchanged devices are not
+ * queried again. The root is configurable (--dev-root) so enumeration can be
+ * exercised against a fake device directory; nodes that do not answer the
+ * ioctl (plain files, non-V4L2 drivers) are reported as unverified.
+ *
+ * Where no video nodes exist (macOS, Windows) the tools fall back to probing
+ * VideoCapture indices.
+ */
+
+#ifndef CAMERA_INVENTORY_H
+#define CAMERA_INVENTORY_H
+
+#include <string>
+#include <vector>
+
+const char *const DEFAULT_DEVICE_ROOT = "/dev";
+const char *const DEFAULT_CAMERA_INVENTORY = "camera_inventory.txt";
+const int FALLBACK_PROBE_COUNT = 5;  // VideoCapture indices probed without video nodes
+
+struct CameraDevice {
+    std::string path;       // e.g. /dev/video0
+    int index = -1;         // N of videoN, the VideoCapture index
+    bool queried = false;   // Capabilities came from VIDIOC_QUERYCAP
+    bool canCapture = false;
+    std::string driver;
+    std::string card;       // Human-readable device name
+    std::string busInfo;
+};
+
+// All video nodes under root, sorted by index (cached where unchanged)
+std::vector<CameraDevice> enumerateCameras(const std::string &root = DEFAULT_DEVICE_ROOT,
+                                           const std::string &inventoryFile = DEFAULT_CAMERA_INVENTORY);
+
+// VideoCapture indices of capture-capable (or unverified) nodes; probes
+// indices 0..FALLBACK_PROBE_COUNT-1 when the root has no video nodes
+std::vector<int> availableCameraIndices(const std::string &root = DEFAULT_DEVICE_ROOT,
+                                        const std::string &inventoryFile = DEFAULT_CAMERA_INVENTORY,
+                                        bool verbose = true);
+
+// Value of "--dev-root <dir>" in argv, or the default root
+std::string deviceRootFromArgs(int argc, char **argv);
+
+#endif // CAMERA_INVENTORY_H
@@ -8,9 +8,28 @@
   and translation (Tx, Ty, Tz) relative to the pattern in real time. 
   Displays these values as the camera moves, allowing observation of pose changes 
   as the target is shifted side to side or rotated.
+
+  Usage: camera_pose [--camera-id <id>]   (intrinsics from camera_intrinsics.store,
+         camera_intrinsics.yml for the default camera)
+                    [--replay <file.frec> [--replay-fast]] [--record <file.frec> [--record-png]]
+                    [--luma] [--no-display] [--fps <rate>] [--degrade]
+                    [--detector classic|sb|auto] [--subpix gradient|saddle]
+                    [--assert-no-alloc]   (Debug builds, see alloc_counter.h)
+  --luma captures YUYV/NV12 and detects on the luma plane; --no-display only logs
+  the pose, so frames are never converted to BGR. --fps paces the loop to a
+  target rate (default: the source's); --degrade detects at reduced resolution
+  while frames run over budget. --detector picks the board detector (see
+  board_detector.h); auto times both on the first frames. --subpix saddle
+  refines corners with the faster, less accurate saddle fit (board_subpix.h).
 */
 
 #include <opencv2/opencv.hpp>
+#include "intrinsics_store.h"
+#include "board_detection.h"
+#include "board_detector.h"
+#include "frame_recording.h"
+#include "alloc_counter.h"
+#include "frame_scheduler.h"
 #include <iostream>
 #include <vector>
 #include <fstream>
@@ -19,34 +38,21 @@
 using namespace cv;
 using namespace std;
 
-// Function to read camera parameters from a YAML file
-bool readCameraParameters(const string &filename, Mat &cameraMatrix, Mat &distCoeffs) {
-    FileStorage fs(filename, FileStorage::READ);
-    if (!fs.isOpened()) {
-        cerr << "Failed to open camera parameters file: " << filename << endl;
-        return false;
-    }
-    fs["camera_matrix"] >> cameraMatrix;
-    fs["distortion_coefficients"] >> distCoeffs;
-    fs.release();
-    return true;
-}
-
 // Function to convert rotation vector to Euler angles (degrees)
 Vec3f rotationVectorToEulerAngles(const Mat &rvec) {
-    Mat R;
+    Matx33d R;  // Fixed size: no allocation per frame
     Rodrigues(rvec, R);
 
-    double sy = sqrt(R.at<double>(0,0)*R.at<double>(0,0) + R.at<double>(1,0)*R.at<double>(1,0));
+    double sy = sqrt(R(0,0)*R(0,0) + R(1,0)*R(1,0));
     double x, y, z;
 
     if (sy >= 1e-6) {
-        x = atan2(R.at<double>(2,1), R.at<double>(2,2));
-        y = atan2(-R.at<double>(2,0), sy);
-        z = atan2(R.at<double>(1,0), R.at<double>(0,0));
+        x = atan2(R(2,1), R(2,2));
+        y = atan2(-R(2,0), sy);
+        z = atan2(R(1,0), R(0,0));
     } else {
-        x = atan2(-R.at<double>(1,2), R.at<double>(1,1));
-        y = atan2(-R.at<double>(2,0), sy);
+        x = atan2(-R(1,2), R(1,1));
+        y = atan2(-R(2,0), sy);
         z = 0;
     }
 
@@ -57,29 +63,26 @@ Vec3f rotationVectorToEulerAngles(const Mat &rvec) {
     return Vec3f(x, y, z);
 }
 
-int main() {
+int main(int argc, char** argv) {
     // Checkerboard dimensions (internal corners)
     const int boardWidth = 9;
     const int boardHeight = 6;
     const float squareSize = 1.0f;
 
     // Prepare 3D object points for checkerboard corners
-    vector<Point3f> objectPoints;
-    for (int i = 0; i < boardHeight; i++) {
-        for (int j = 0; j < boardWidth; j++) {
-            objectPoints.push_back(Point3f(j * squareSize, i * squareSize, 0));
-        }
-    }
+    vector<Point3f> objectPoints = boardObjectPoints(Size(boardWidth, boardHeight), squareSize);
 
-    // Load camera calibration
-    Mat cameraMatrix, distCoeffs;
-    if (!readCameraParameters("camera_intrinsics.yml", cameraMatrix, distCoeffs)) {
-        return -1;
-    }
+    // Camera calibration, looked up once the capture resolution is known
+    string cameraId = cameraIdFromArgs(argc, argv);
+    CameraIntrinsics intrinsics;
+    Mat distCoeffs;
+    Mat cameraMatrix;
+    Size cameraMatrixSize;  // Frame size cameraMatrix was scaled for
 
     // Open video capture
-    VideoCapture cap(0);
-    if (!cap.isOpened()) {
+    // Camera 0, or a recording (--replay)
+    FrameSource cap;
+    if (!cap.open(argc, argv, 0)) {
         cerr << "Cannot open camera" << endl;
         return -1;
     }
@@ -89,27 +92,48 @@ int main() {
     csvFile << "Frame,Pitch,Yaw,Roll,Tx,Ty,Tz\n";
 
     int frameCount = 0;
+    bool display = true;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--no-display") display = false;
+    }
+
+    // Working set reused every frame: the loop does not allocate once warm
+    FramePyramid pyramid;  // Level buffers persist across frames
+    LumaFrame frame;  // Gray for detection, BGR converted only for display
+    vector<Point2f> corners;
+    Mat rvec, tvec;
+    FrameAllocationMonitor allocations("camera_pose");
+    allocations.configure(argc, argv);
+    FrameScheduler scheduler;
+    scheduler.configure(argc, argv, cap.fps());
+    unique_ptr<BoardDetector> detector = createBoardDetector(argc, argv);
 
     while (true) {
-        Mat frame, gray;
+        allocations.beginFrame();
         cap >> frame;
+        scheduler.beginFrame();  // Processing time starts once the frame is in
         if (frame.empty()) break;
+        pyramid.reset(frame.gray());
+
+        // Intrinsics follow the capture resolution: its own calibration if
+        // there is one, else the closest one rescaled
+        if (frame.size() != cameraMatrixSize) {
+            if (!loadCameraIntrinsics(cameraId, frame.size(), intrinsics)) return -1;
+            cameraMatrix = scaledCameraMatrix(intrinsics, frame.size());
+            distCoeffs = intrinsics.distCoeffs;
+            cameraMatrixSize = frame.size();
+        }
 
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
-
-        vector<Point2f> corners;
-        bool found = findChessboardCorners(gray, Size(boardWidth, boardHeight), corners,
-                                           CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
-
+        // Smaller pyramid level while frames run over budget
+        detector->setMaxDetectionWidth(scheduler.degraded() ? reducedDetectionWidth(frame.size().width)
+                                                            : DEFAULT_DETECTION_WIDTH);
+        bool found = detector->detect(pyramid, Size(boardWidth, boardHeight), corners);
         if (found) {
-            cornerSubPix(gray, corners, Size(11, 11), Size(-1, -1),
-                         TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.1));
-
-            drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners, found);
-
-            Mat rvec, tvec;
+            AllocationScope scope("solvePnP");
             solvePnP(objectPoints, corners, cameraMatrix, distCoeffs, rvec, tvec);
+        }
 
+        if (found) {
             Vec3f eulerAngles = rotationVectorToEulerAngles(rvec);
 
             // Print to console
@@ -128,26 +152,35 @@ int main() {
                     << tvec.at<double>(1) << "," 
                     << tvec.at<double>(2) << "\n";
 
-            // Draw 3D axes
-            vector<Point3f> axisPoints = {Point3f(0,0,0), Point3f(3*squareSize,0,0),
-                                          Point3f(0,3*squareSize,0), Point3f(0,0,-3*squareSize)};
-            vector<Point2f> imagePoints;
-            projectPoints(axisPoints, rvec, tvec, cameraMatrix, distCoeffs, imagePoints);
-
-            line(frame, imagePoints[0], imagePoints[1], Scalar(0,0,255), 2);
-            line(frame, imagePoints[0], imagePoints[2], Scalar(0,255,0), 2);
-            line(frame, imagePoints[0], imagePoints[3], Scalar(255,0,0), 2);
+            // Draw corners and 3D axes
+            if (display) {
+                {
+                    AllocationScope scope("drawChessboardCorners");
+                    drawChessboardCorners(frame.bgr(), Size(boardWidth, boardHeight), corners, found);
+                }
+                drawPoseAxes(frame.bgr(), rvec, tvec, cameraMatrix, distCoeffs, 3 * squareSize);
+            }
         }
 
-        imshow("Checkerboard Pose Estimation", frame);
-        char key = (char)waitKey(30);
-        if (key == 27) break;
+        if (display) {
+            {
+                AllocationScope scope("imshow");
+                imshow("Checkerboard Pose Estimation", frame.bgr());
+            }
+            char key = (char)scheduler.waitKey();
+            if (key == 27) break;
+        } else {
+            scheduler.endFrame();
+        }
 
+        allocations.endFrame();
         frameCount++;
     }
 
+    cout << "Timing: " << scheduler.summary() << endl;
+
     csvFile.close();
     cap.release();
     destroyAllWindows();
-    return 0;
+    return allocations.finish() ? 0 : 1;
 }
@@ -12,13 +12,20 @@
 
   Used to verify that the camera can consistently locate the
   calibration target before proceeding to the calibration step.
+
+  Usage: detect_checkerboard [--replay <file.frec> [--replay-fast]]
+                             [--record <file.frec> [--record-png]]
+                             [--detector classic|sb|auto]   (see board_detector.h)
+                             [--subpix gradient|saddle]     (corner refinement, board_subpix.h)
 */
 
 #include <opencv2/opencv.hpp>
+#include "board_detector.h"
+#include "frame_recording.h"
 #include <iostream>
 #include <vector>
 
-int main() {
+int main(int argc, char** argv) {
     // --- Define the checkerboard dimensions ---
     // These are the number of internal corners per row and column
     cv::Size patternSize(9, 6);  // 9 columns and 6 rows of internal corners
@@ -27,33 +34,33 @@ int main() {
     std::vector<cv::Point2f> corner_set;
 
     // --- Open video stream (0 = default camera) ---
-    cv::VideoCapture cap(0);
-    if (!cap.isOpened()) {
+    FrameSource cap;
+    if (!cap.open(argc, argv, 0)) {
         std::cerr << "Error: Could not open camera.\n";
         return -1;
     }
 
+    // Full-resolution search; corners come back subpixel-refined
+    std::unique_ptr<BoardDetector> detector = createBoardDetector(argc, argv,
+        cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_FAST_CHECK | cv::CALIB_CB_NORMALIZE_IMAGE);
+    detector->setMaxDetectionWidth(0);
+    FramePyramid pyramid;
+
     std::cout << "Press 'q' to quit.\n";
 
+    LumaFrame frame;  // Gray for detection, BGR converted only for display
     while (true) {
-        cv::Mat frame, gray;
         cap >> frame;
         if (frame.empty()) break;
 
-        // Convert to grayscale
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        pyramid.reset(frame.gray());
 
         // Try to find the checkerboard corners
-        bool found = cv::findChessboardCorners(gray, patternSize, corner_set,
-                                               cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_FAST_CHECK | cv::CALIB_CB_NORMALIZE_IMAGE);
+        bool found = detector->detect(pyramid, patternSize, corner_set);
 
         if (found) {
-            // Refine corner locations for subpixel accuracy
-            cv::cornerSubPix(gray, corner_set, cv::Size(11, 11), cv::Size(-1, -1),
-                             cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.001));
-
             // Draw corners on the image
-            cv::drawChessboardCorners(frame, patternSize, corner_set, found);
+            cv::drawChessboardCorners(frame.bgr(), patternSize, corner_set, found);
 
             // Print info
             std::cout << "Corners found: " << corner_set.size() << std::endl;
@@ -63,7 +70,7 @@ int main() {
         }
 
         // Display result
-        cv::imshow("Checkerboard Detection", frame);
+        cv::imshow("Checkerboard Detection", frame.bgr());
 
         // Exit when 'q' is pressed
         if (cv::waitKey(10) == 'q') break;
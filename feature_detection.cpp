@@ -7,16 +7,63 @@
  ---------------------------------------------------------
  * Implements Harris corner and ORB feature detection with marker-less AR tracking.
  * Demonstrates feature-based augmented reality using homography estimation.
+ * Once locked, the target is followed with optical flow and ORB matching only
+ * runs again when inliers are lost or every REDETECT_INTERVAL frames.
  * 
  * Controls: 1=Harris, 2=ORB, 3=Both, 4=AR Mode (SPACE to capture reference)
  *           +/-=Harris threshold, w/s=ORB features, r=Reset, c=Checkerboard, h=Help
+ *           u=Toggle PROSAC/RANSAC, m=Record match set for homography_benchmark
+ *           t=Toggle plane texture
+ *
+ * Usage: feature_detection                                  (live camera)
+ *        feature_detection <image>                          (static image AR)
+ *        feature_detection --enroll <image> <target.artarget>
+ *        feature_detection --target <target.artarget>        (live AR on enrolled target)
+ *        feature_detection --batch <dir|list.txt> [--jobs N] [--out dir] [--manifest file]
+ *        Live modes accept --dev-root <dir> to enumerate cameras under dir instead of /dev.
+ *        --texture <image|video> composites the texture onto the tracked plane in AR mode.
+ *        Live modes accept --replay <file.frec> [--replay-fast] to run on a recording
+ *        instead of the camera, and --record <file.frec> [--record-png] to make one.
+ *        --luma captures YUYV/NV12 and takes the gray image from the luma plane.
+ *        --fps <rate> paces the live loop to a target rate (default: the source's);
+ *        --degrade runs the checkerboard overlay at reduced resolution while frames
+ *        run over budget.
+ *        --detector classic|sb|auto picks the overlay's board detector (board_detector.h),
+ *        --subpix gradient|saddle its corner refinement (board_subpix.h).
+ *
+ * Enrolled targets store keypoints and descriptors in a binary file that is
+ * memory-mapped at startup instead of re-running ORB on the reference image.
+ * Static image mode picks up a sibling <image>.artarget automatically.
  */
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/features2d.hpp>
+#include <opencv2/video/tracking.hpp>
+#include "batch_pipeline.h"
+#include "board_detection.h"
+#include "board_detector.h"
+#include "frame_pyramid.h"
+#include "camera_inventory.h"
+#include "plane_overlay.h"
+#include "harris_corners.h"
+#include "homography_estimation.h"
+#include "frame_recording.h"
+#include "frame_scheduler.h"
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace cv;
 using namespace std;
@@ -27,11 +74,51 @@ int orbMaxFeatures = 500;
 bool showCheckerboard = false;
 
 bool arModeActive = false;
-Mat referenceImage;
+Size referenceSize;
 vector<KeyPoint> referenceKeypoints;
 Mat referenceDescriptors;
 Ptr<ORB> orbDetector;
 
+// Tracking state for AR mode: full ORB detection until the target is locked,
+// then pyramidal optical flow on the inliers until they are lost.
+enum TrackingState { STATE_DETECTING, STATE_TRACKING };
+TrackingState trackingState = STATE_DETECTING;
+FramePyramid prevPyramid;           // Previous AR frame, swapped with the current one
+vector<Point2f> trackedRefPoints;   // Inlier locations in the reference image
+vector<Point2f> trackedCurrPoints;  // Same inliers in the previous frame
+int framesSinceDetection = 0;
+Mat lastHomography;                 // Most recent reference -> frame homography
+
+// Optional texture (image or looping video) composited onto the tracked plane
+PlaneOverlay planeOverlay;
+VideoCapture textureVideo;
+bool showTexture = true;
+
+const int MIN_TRACKED_INLIERS = 15;  // Re-detect when fewer inliers survive
+const int REDETECT_INTERVAL = 30;    // Forced full detection every N frames
+const Size FLOW_WIN_SIZE(21, 21);    // Lucas-Kanade window
+const int FLOW_MAX_LEVEL = 3;
+
+// Tracking working set, reused every frame
+vector<Point2f> flowNextPoints;
+vector<uchar> flowStatus;
+vector<float> flowError;
+Mat flowInlierMask;
+
+// Homography-guided matching: current keypoints are bucketed into a grid and
+// each reference descriptor is only compared against its predicted neighbourhood
+const int GRID_CELL_SIZE = 32;        // Grid cell size in pixels
+const float GUIDED_SEARCH_RADIUS = 40.0f;
+const int GUIDED_MAX_HAMMING = 64;    // Accept a lone candidate below this distance
+const size_t MIN_GOOD_MATCHES = 10;
+
+// Robust estimator: PROSAC sampling over distance-ordered matches with local
+// optimization (USAC), or OpenCV's classic uniform RANSAC
+bool useProsac = true;
+int matchSetCount = 0;
+vector<Point2f> lastMatchRefPoints, lastMatchCurrPoints;  // Last match set, for recording
+vector<float> lastMatchDistances;
+
 void printHelp() {
     cout << "\n=== CONTROLS ===" << endl;
     cout << "1/2/3/4 - Harris/ORB/Both/AR Mode" << endl;
@@ -39,48 +126,11 @@ void printHelp() {
     cout << "+/- - Harris threshold" << endl;
     cout << "w/s - ORB features count" << endl;
     cout << "c - Toggle checkerboard" << endl;
+    cout << "u - Toggle PROSAC/RANSAC, m - Record match set (mode 4)" << endl;
+    cout << "t - Toggle plane texture (mode 4, with --texture)" << endl;
     cout << "r - Reset, p - Save, h - Help, ESC - Exit\n" << endl;
 }
 
-// Harris corner detection
-void detectHarrisCorners(const Mat &gray, vector<Point2f> &corners, double threshold) {
-    Mat dst, dst_norm;
-    
-    cornerHarris(gray, dst, 2, 3, 0.04);
-    
-    // Normalize
-    normalize(dst, dst_norm, 0, 255, NORM_MINMAX, CV_32FC1, Mat());
-    convertScaleAbs(dst_norm, dst_norm_scaled);
-    
-    // Threshold and find local maxima
-    corners.clear();
-    for (int j = 0; j < dst_norm.rows; j++) {
-        for (int i = 0; i < dst_norm.cols; i++) {
-            if ((float)dst_norm.at<float>(j, i) > threshold * 255) {
-                corners.push_back(Point2f(i, j));
-            }
-        }
-    }
-    
-    // Non-maximum suppression (simple version)
-    if (corners.size() > 1000) {
-        // Sort by response strength
-        vector<pair<float, Point2f>> scored;
-        for (const auto &pt : corners) {
-            scored.push_back({dst_norm.at<float>(pt.y, pt.x), pt});
-        }
-        // Sort by first element (response strength) in descending order
-        sort(scored.begin(), scored.end(), [](const pair<float, Point2f>& a, const pair<float, Point2f>& b) {
-            return a.first > b.first;  // Greater response first
-        });
-        
-        corners.clear();
-        for (size_t i = 0; i < min((size_t)1000, scored.size()); i++) {
-            corners.push_back(scored[i].second);
-        }
-    }
-}
-
 // Draw Harris corners on image
 void drawHarrisCorners(Mat &img, const vector<Point2f> &corners) {
     for (const auto &pt : corners) {
@@ -98,49 +148,218 @@ void detectAndDrawORB(Mat &img, const Mat &gray, int maxFeatures) {
     drawKeypoints(img, keypoints, img, Scalar(255, 0, 255), DrawMatchesFlags::DRAW_RICH_KEYPOINTS);
 }
 
-// AR Mode: Feature matching and homography
-void processARMode(Mat &frame, const Mat &gray) {
-    if (!arModeActive) {
-        putText(frame, "AR Mode: Press SPACE to capture reference", Point(10, 30),
-                FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 255, 255), 2);
-        return;
+// Drop tracked points so the next AR frame runs full detection
+void resetTracking() {
+    trackingState = STATE_DETECTING;
+    trackedRefPoints.clear();
+    trackedCurrPoints.clear();
+    framesSinceDetection = 0;
+    lastHomography.release();
+}
+
+// Keep only the correspondences flagged as inliers by findHomography
+void keepInliers(const Mat &mask, vector<Point2f> &refPoints, vector<Point2f> &currPoints) {
+    size_t n = 0;
+    for (size_t i = 0; i < refPoints.size(); i++) {
+        if (mask.at<uchar>((int)i)) {
+            refPoints[n] = refPoints[i];
+            currPoints[n] = currPoints[i];
+            n++;
+        }
     }
+    refPoints.resize(n);
+    currPoints.resize(n);
+}
+
+// Uniform grid over keypoint positions, stored as flattened per-cell index lists
+struct KeypointGrid {
+    int cols = 0, rows = 0;
+    vector<int> cellStart;   // cellStart[c]..cellStart[c+1] indexes into items
+    vector<int> items;       // Keypoint indices sorted by cell
+};
+
+void buildKeypointGrid(const vector<KeyPoint> &keypoints, Size imageSize, KeypointGrid &grid) {
+    grid.cols = (imageSize.width + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE;
+    grid.rows = (imageSize.height + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE;
+    int numCells = grid.cols * grid.rows;
     
-    vector<KeyPoint> currentKeypoints;
-    Mat currentDescriptors;
-    orbDetector->detectAndCompute(gray, noArray(), currentKeypoints, currentDescriptors);
-    
-    if (currentDescriptors.empty() || referenceDescriptors.empty()) return;
+    vector<int> cellOf(keypoints.size());
+    grid.cellStart.assign(numCells + 1, 0);
+    for (size_t i = 0; i < keypoints.size(); i++) {
+        int cx = min(max((int)(keypoints[i].pt.x / GRID_CELL_SIZE), 0), grid.cols - 1);
+        int cy = min(max((int)(keypoints[i].pt.y / GRID_CELL_SIZE), 0), grid.rows - 1);
+        cellOf[i] = cy * grid.cols + cx;
+        grid.cellStart[cellOf[i] + 1]++;
+    }
+    for (int c = 0; c < numCells; c++) grid.cellStart[c + 1] += grid.cellStart[c];
     
-    // Match features
+    grid.items.resize(keypoints.size());
+    vector<int> fill(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t i = 0; i < keypoints.size(); i++) {
+        grid.items[fill[cellOf[i]]++] = (int)i;
+    }
+}
+
+// Brute-force kNN over all current descriptors with Lowe's ratio test
+void matchGlobal(const Mat &currentDescriptors, vector<DMatch> &goodMatches) {
     BFMatcher matcher(NORM_HAMMING);
     vector<vector<DMatch>> knnMatches;
     matcher.knnMatch(referenceDescriptors, currentDescriptors, knnMatches, 2);
     
-    // Lowe's ratio test
-    vector<DMatch> goodMatches;
+    goodMatches.clear();
     for (size_t i = 0; i < knnMatches.size(); i++) {
         if (knnMatches[i].size() >= 2 && 
             knnMatches[i][0].distance < 0.75f * knnMatches[i][1].distance) {
             goodMatches.push_back(knnMatches[i][0]);
         }
     }
+}
+
+// Match each reference descriptor only against current keypoints near its
+// position predicted by the previous homography
+void matchGuided(const vector<KeyPoint> &currentKeypoints, const Mat &currentDescriptors,
+                 Size imageSize, const Mat &prevH, vector<DMatch> &goodMatches) {
+    goodMatches.clear();
     
-    if (goodMatches.size() < 10) return;
+    vector<Point2f> refPoints, predicted;
+    KeyPoint::convert(referenceKeypoints, refPoints);
+    perspectiveTransform(refPoints, predicted, prevH);
+    
+    KeypointGrid grid;
+    buildKeypointGrid(currentKeypoints, imageSize, grid);
+    
+    const float radiusSq = GUIDED_SEARCH_RADIUS * GUIDED_SEARCH_RADIUS;
+    const int cellRadius = (int)ceil(GUIDED_SEARCH_RADIUS / GRID_CELL_SIZE);
+    
+    for (int i = 0; i < (int)predicted.size(); i++) {
+        const Point2f &p = predicted[i];
+        if (p.x < -GUIDED_SEARCH_RADIUS || p.y < -GUIDED_SEARCH_RADIUS ||
+            p.x > imageSize.width + GUIDED_SEARCH_RADIUS ||
+            p.y > imageSize.height + GUIDED_SEARCH_RADIUS) continue;
+        
+        int cx = (int)floor(p.x / GRID_CELL_SIZE);
+        int cy = (int)floor(p.y / GRID_CELL_SIZE);
+        int best = -1;
+        int bestDist = INT_MAX, secondDist = INT_MAX;
+        const Mat refDesc = referenceDescriptors.row(i);
+        
+        for (int gy = max(cy - cellRadius, 0); gy <= min(cy + cellRadius, grid.rows - 1); gy++) {
+            for (int gx = max(cx - cellRadius, 0); gx <= min(cx + cellRadius, grid.cols - 1); gx++) {
+                int c = gy * grid.cols + gx;
+                for (int k = grid.cellStart[c]; k < grid.cellStart[c + 1]; k++) {
+                    int j = grid.items[k];
+                    Point2f d = currentKeypoints[j].pt - p;
+                    if (d.x * d.x + d.y * d.y > radiusSq) continue;
+                    
+                    int dist = (int)norm(refDesc, currentDescriptors.row(j), NORM_HAMMING);
+                    if (dist < bestDist) {
+                        secondDist = bestDist;
+                        bestDist = dist;
+                        best = j;
+                    } else if (dist < secondDist) {
+                        secondDist = dist;
+                    }
+                }
+            }
+        }
+        
+        if (best < 0) continue;
+        bool accepted = (secondDist == INT_MAX) ? (bestDist < GUIDED_MAX_HAMMING)
+                                                : (bestDist < 0.75f * secondDist);
+        if (accepted) goodMatches.push_back(DMatch(i, best, (float)bestDist));
+    }
+}
+
+// Estimate H from matches and seed the tracker with the RANSAC inliers
+bool estimateHomography(const vector<KeyPoint> &currentKeypoints,
+                        vector<DMatch> &goodMatches, Mat &H) {
+    if (goodMatches.size() < MIN_GOOD_MATCHES) return false;
+    
+    // Best descriptor distance first, as required by PROSAC sampling
+    sort(goodMatches.begin(), goodMatches.end(),
+         [](const DMatch &a, const DMatch &b) { return a.distance < b.distance; });
     
     // Extract points and find homography
     vector<Point2f> refPoints, currPoints;
+    lastMatchDistances.clear();
     for (size_t i = 0; i < goodMatches.size(); i++) {
         refPoints.push_back(referenceKeypoints[goodMatches[i].queryIdx].pt);
         currPoints.push_back(currentKeypoints[goodMatches[i].trainIdx].pt);
+        lastMatchDistances.push_back(goodMatches[i].distance);
     }
+    lastMatchRefPoints = refPoints;
+    lastMatchCurrPoints = currPoints;
     
-    Mat H = findHomography(refPoints, currPoints, RANSAC, 3.0);
-    if (H.empty()) return;
+    Mat inlierMask;
+    H = findHomographyRobust(refPoints, currPoints, inlierMask, useProsac);
+    if (H.empty()) return false;
+    
+    keepInliers(inlierMask, refPoints, currPoints);
+    trackedRefPoints = refPoints;
+    trackedCurrPoints = currPoints;
+    return true;
+}
+
+// Full ORB detection + matching against the reference image
+bool detectHomography(const Mat &gray, Mat &H) {
+    vector<KeyPoint> currentKeypoints;
+    Mat currentDescriptors;
+    orbDetector->detectAndCompute(gray, noArray(), currentKeypoints, currentDescriptors);
+    
+    if (currentDescriptors.empty() || referenceDescriptors.empty()) return false;
+    
+    vector<DMatch> goodMatches;
     
-    // Project virtual object
-    int refWidth = referenceImage.cols;
-    int refHeight = referenceImage.rows;
+    // Spatially guided matching when a previous pose is known
+    if (!lastHomography.empty()) {
+        matchGuided(currentKeypoints, currentDescriptors, gray.size(), lastHomography, goodMatches);
+        if (estimateHomography(currentKeypoints, goodMatches, H)) return true;
+    }
+    
+    // Fall back to global matching
+    matchGlobal(currentDescriptors, goodMatches);
+    return estimateHomography(currentKeypoints, goodMatches, H);
+}
+
+// Follow the inliers from the previous frame with pyramidal Lucas-Kanade
+bool trackHomography(FramePyramid &pyramid, Mat &H) {
+    if (prevPyramid.empty() || prevPyramid.size() != pyramid.size() ||
+        (int)trackedCurrPoints.size() < MIN_TRACKED_INLIERS) return false;
+    
+    // Both frames' levels come from their shared pyramids; the previous
+    // frame's was built before it was swapped out (see processARMode)
+    vector<Point2f> &nextPoints = flowNextPoints;
+    vector<uchar> &status = flowStatus;
+    calcOpticalFlowPyrLK(prevPyramid.opticalFlowPyramid(FLOW_WIN_SIZE, FLOW_MAX_LEVEL),
+                         pyramid.opticalFlowPyramid(FLOW_WIN_SIZE, FLOW_MAX_LEVEL),
+                         trackedCurrPoints, nextPoints, status, flowError, FLOW_WIN_SIZE, FLOW_MAX_LEVEL,
+                         TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 20, 0.03));
+    
+    // Keep successfully tracked points
+    size_t n = 0;
+    for (size_t i = 0; i < status.size(); i++) {
+        if (status[i]) {
+            trackedRefPoints[n] = trackedRefPoints[i];
+            nextPoints[n] = nextPoints[i];
+            n++;
+        }
+    }
+    trackedRefPoints.resize(n);
+    nextPoints.resize(n);
+    if ((int)n < MIN_TRACKED_INLIERS) return false;
+    
+    H = findHomography(trackedRefPoints, nextPoints, RANSAC, 3.0, flowInlierMask);
+    if (H.empty()) return false;
+    
+    keepInliers(flowInlierMask, trackedRefPoints, nextPoints);
+    trackedCurrPoints = nextPoints;
+    return (int)trackedCurrPoints.size() >= MIN_TRACKED_INLIERS;
+}
+
+// Draw the virtual rectangle of the reference image mapped through H
+void drawARObject(Mat &frame, const Mat &H) {
+    int refWidth = referenceSize.width;
+    int refHeight = referenceSize.height;
     vector<Point2f> refObjectCorners = {
         Point2f(refWidth * 0.3f, refHeight * 0.3f),
         Point2f(refWidth * 0.7f, refHeight * 0.3f),
@@ -165,8 +384,367 @@ void processARMode(Mat &frame, const Mat &gray) {
     circle(frame, center, 8, Scalar(0, 255, 255), -1);
 }
 
+// AR Mode: track the locked target, fall back to feature matching when lost
+void processARMode(Mat &frame, FramePyramid &pyramid) {
+    if (!arModeActive) {
+        putText(frame, "AR Mode: Press SPACE to capture reference", Point(10, 30),
+                FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 255, 255), 2);
+        return;
+    }
+    
+    Mat H;
+    bool locked = false;
+    bool tracked = false;
+    
+    // Cheap path: optical flow while locked, with a periodic full re-detection
+    if (trackingState == STATE_TRACKING && framesSinceDetection < REDETECT_INTERVAL) {
+        tracked = trackHomography(pyramid, H);
+        locked = tracked;
+    }
+    if (!locked) {
+        locked = detectHomography(pyramid.level(0), H);
+        framesSinceDetection = 0;
+    }
+    
+    // Keep this frame for the next one; the caller resets the swapped-in
+    // pyramid (and reuses its buffers) on the next frame. Level 0 views the
+    // capture's gray buffer, which the next frame overwrites, so the flow
+    // levels (own copies) are built while they still hold this frame.
+    if (locked) pyramid.opticalFlowPyramid(FLOW_WIN_SIZE, FLOW_MAX_LEVEL);
+    swap(prevPyramid, pyramid);
+    
+    if (!locked) {
+        resetTracking();
+        return;
+    }
+    
+    // Only hand over to the tracker when enough inliers support the lock
+    trackingState = ((int)trackedCurrPoints.size() >= MIN_TRACKED_INLIERS)
+                    ? STATE_TRACKING : STATE_DETECTING;
+    framesSinceDetection++;
+    lastHomography = H;
+    
+    bool textured = showTexture && planeOverlay.hasTexture();
+    if (textured) {
+        // Next video frame, looping at the end
+        if (textureVideo.isOpened()) {
+            Mat videoFrame;
+            if (!textureVideo.read(videoFrame)) {
+                textureVideo.set(CAP_PROP_POS_FRAMES, 0);
+                textureVideo.read(videoFrame);
+            }
+            if (!videoFrame.empty()) planeOverlay.setTexture(videoFrame);
+        }
+        // Same region of the reference as the virtual rectangle
+        Rect2f region(referenceSize.width * 0.3f, referenceSize.height * 0.3f,
+                      referenceSize.width * 0.4f, referenceSize.height * 0.4f);
+        planeOverlay.draw(frame, H, region);
+    } else {
+        drawARObject(frame, H);
+    }
+    
+    string status = string(tracked ? "Tracking" : "Detecting") +
+                    " (" + to_string(trackedCurrPoints.size()) + " inliers)";
+    if (textured) {
+        char overlayMs[32];
+        snprintf(overlayMs, sizeof(overlayMs), ", overlay %.1f ms", planeOverlay.lastMs());
+        status += overlayMs;
+    }
+    putText(frame, status, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 255, 0), 2);
+}
+
+// Precomputed reference target file (.artarget). All sections are plain
+// little-endian arrays so the file can be mapped and used without parsing.
+const char TARGET_MAGIC[8] = {'A', 'R', 'T', 'A', 'R', 'G', 'T', '\0'};
+const uint32_t TARGET_VERSION = 1;
+
+struct TargetFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t imageWidth;
+    uint32_t imageHeight;
+    uint32_t numKeypoints;
+    uint32_t descriptorBytes;   // Bytes per descriptor row (32 for ORB)
+    uint32_t descriptorType;    // OpenCV type of the descriptor matrix
+    uint64_t keypointOffset;
+    uint64_t descriptorOffset;
+    uint64_t indexOffset;       // Optional spatial index section, 0 when absent
+    uint64_t indexBytes;
+};
+
+struct TargetFileKeypoint {
+    float x, y, size, angle, response;
+    int32_t octave, classId;
+};
+
+// Mapping that backs referenceDescriptors while a target file is in use
+struct MappedTarget {
+    const uchar *data = nullptr;
+    size_t size = 0;
+    vector<uchar> buffer;  // Read fallback where mmap is unavailable
+};
+MappedTarget referenceMapping;
+
+uint64_t alignOffset(uint64_t offset) {
+    return (offset + 63) & ~uint64_t(63);
+}
+
+void unmapTarget() {
+#ifndef _WIN32
+    if (referenceMapping.data && referenceMapping.buffer.empty()) {
+        munmap((void*)referenceMapping.data, referenceMapping.size);
+    }
+#endif
+    referenceMapping = MappedTarget();
+}
+
+// Write keypoints and descriptors of an enrolled reference image
+bool writeTargetFile(const string &filename, Size imageSize,
+                     const vector<KeyPoint> &keypoints, const Mat &descriptors) {
+    if (descriptors.rows != (int)keypoints.size() || !descriptors.isContinuous() ||
+        descriptors.type() != CV_8UC1) {
+        cerr << "Error: Descriptors do not match keypoints" << endl;
+        return false;
+    }
+    
+    TargetFileHeader header = {};
+    memcpy(header.magic, TARGET_MAGIC, sizeof(header.magic));
+    header.version = TARGET_VERSION;
+    header.imageWidth = imageSize.width;
+    header.imageHeight = imageSize.height;
+    header.numKeypoints = (uint32_t)keypoints.size();
+    header.descriptorBytes = (uint32_t)(descriptors.cols * descriptors.elemSize());
+    header.descriptorType = descriptors.type();
+    header.keypointOffset = alignOffset(sizeof(TargetFileHeader));
+    header.descriptorOffset = alignOffset(header.keypointOffset +
+                                          keypoints.size() * sizeof(TargetFileKeypoint));
+    
+    vector<TargetFileKeypoint> packed(keypoints.size());
+    for (size_t i = 0; i < keypoints.size(); i++) {
+        const KeyPoint &kp = keypoints[i];
+        packed[i] = {kp.pt.x, kp.pt.y, kp.size, kp.angle, kp.response, kp.octave, kp.class_id};
+    }
+    
+    ofstream out(filename, ios::binary);
+    if (!out) {
+        cerr << "Error: Could not write " << filename << endl;
+        return false;
+    }
+    vector<char> padding(64, 0);
+    out.write((const char*)&header, sizeof(header));
+    out.write(padding.data(), header.keypointOffset - sizeof(header));
+    out.write((const char*)packed.data(), packed.size() * sizeof(TargetFileKeypoint));
+    out.write(padding.data(), header.descriptorOffset -
+              (header.keypointOffset + packed.size() * sizeof(TargetFileKeypoint)));
+    out.write((const char*)descriptors.data, (size_t)descriptors.rows * header.descriptorBytes);
+    return (bool)out;
+}
+
+// Offsets and counts come from the file: every section must lie inside it,
+// checked without overflow
+bool targetSectionsValid(const TargetFileHeader &header, size_t size) {
+    if (memcmp(header.magic, TARGET_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TARGET_VERSION) {
+        return false;
+    }
+    // ORB descriptors only: 8-bit rows, matched with Hamming distance
+    if (header.descriptorType != CV_8UC1 || header.descriptorBytes == 0 ||
+        header.numKeypoints > (uint32_t)INT_MAX || header.descriptorBytes > (uint32_t)INT_MAX) {
+        return false;
+    }
+    if (header.keypointOffset > size || header.descriptorOffset > size) return false;
+    if (header.numKeypoints > (size - header.keypointOffset) / sizeof(TargetFileKeypoint)) return false;
+    if (header.numKeypoints > (size - header.descriptorOffset) / header.descriptorBytes) return false;
+    return true;
+}
+
+// Map a target file; descriptors become a Mat header over the mapping
+bool loadTargetFile(const string &filename, Size &imageSize,
+                    vector<KeyPoint> &keypoints, Mat &descriptors) {
+    // descriptors may still point into the old mapping
+    descriptors.release();
+    keypoints.clear();
+    unmapTarget();
+    MappedTarget mapping;
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(TargetFileHeader)) {
+        close(fd);
+        return false;
+    }
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return false;
+    mapping.data = (const uchar*)addr;
+    mapping.size = st.st_size;
+#else
+    ifstream in(filename, ios::binary | ios::ate);
+    if (!in) return false;
+    streamoff fileSize = in.tellg();
+    if (fileSize < (streamoff)sizeof(TargetFileHeader)) return false;
+    mapping.buffer.resize((size_t)fileSize);
+    in.seekg(0);
+    if (!in.read((char*)mapping.buffer.data(), mapping.buffer.size())) return false;
+    mapping.data = mapping.buffer.data();
+    mapping.size = mapping.buffer.size();
+#endif
+    referenceMapping = std::move(mapping);
+    
+    const TargetFileHeader &header = *(const TargetFileHeader*)referenceMapping.data;
+    if (!targetSectionsValid(header, referenceMapping.size)) {
+        cerr << "Error: Invalid target file " << filename << endl;
+        unmapTarget();
+        return false;
+    }
+    
+    imageSize = Size(header.imageWidth, header.imageHeight);
+    
+    const TargetFileKeypoint *packed =
+        (const TargetFileKeypoint*)(referenceMapping.data + header.keypointOffset);
+    keypoints.resize(header.numKeypoints);
+    for (uint32_t i = 0; i < header.numKeypoints; i++) {
+        keypoints[i] = KeyPoint(packed[i].x, packed[i].y, packed[i].size, packed[i].angle,
+                                packed[i].response, packed[i].octave, packed[i].classId);
+    }
+    
+    descriptors = Mat((int)header.numKeypoints, (int)header.descriptorBytes, CV_8UC1,
+                      (void*)(referenceMapping.data + header.descriptorOffset));
+    return true;
+}
+
+// Sibling target file for a static image: foo.jpg -> foo.artarget
+string targetPathForImage(const string &imagePath) {
+    size_t dotPos = imagePath.find_last_of(".");
+    return imagePath.substr(0, dotPos) + ".artarget";
+}
+
+// Offline enrollment: run ORB once on the reference image and save it
+int enrollTarget(const string &imagePath, const string &targetPath) {
+    Mat image = imread(imagePath, IMREAD_GRAYSCALE);
+    if (image.empty()) {
+        cerr << "Error: Could not load image" << endl;
+        return -1;
+    }
+    
+    Ptr<ORB> orb = ORB::create(orbMaxFeatures);
+    vector<KeyPoint> keypoints;
+    Mat descriptors;
+    orb->detectAndCompute(image, noArray(), keypoints, descriptors);
+    
+    if (keypoints.size() < 10) {
+        cerr << "Error: Not enough features" << endl;
+        return -1;
+    }
+    if (!writeTargetFile(targetPath, image.size(), keypoints, descriptors)) return -1;
+    
+    cout << "✓ Enrolled " << keypoints.size() << " ORB features from " << imagePath
+         << " (" << image.cols << "x" << image.rows << ") into " << targetPath << endl;
+    return 0;
+}
+
+// Static image AR: feature dots plus the virtual rectangle in the image centre
+void drawStaticAR(Mat &display, const vector<KeyPoint> &keypoints) {
+    // Draw detected features
+    for (size_t i = 0; i < min(size_t(100), keypoints.size()); i++) {
+        circle(display, keypoints[i].pt, 3, Scalar(255, 0, 255), -1);
+    }
+    
+    // Draw virtual object in center
+    int centerX = display.cols / 2;
+    int centerY = display.rows / 2;
+    int objSize = min(display.cols, display.rows) / 4;
+    
+    vector<Point2f> corners = {
+        Point2f(centerX - objSize, centerY - objSize),
+        Point2f(centerX + objSize, centerY - objSize),
+        Point2f(centerX + objSize, centerY + objSize),
+        Point2f(centerX - objSize, centerY + objSize)
+    };
+    
+    // Draw virtual object (rectangle with diagonals)
+    for (int i = 0; i < 4; i++) {
+        line(display, corners[i], corners[(i + 1) % 4], Scalar(0, 255, 0), 3, LINE_AA);
+    }
+    line(display, corners[0], corners[2], Scalar(0, 255, 0), 2, LINE_AA);
+    line(display, corners[1], corners[3], Scalar(0, 255, 0), 2, LINE_AA);
+    
+    // Draw center point
+    circle(display, Point(centerX, centerY), 10, Scalar(0, 255, 255), -1);
+    
+    // Add text
+    putText(display, "AR Target Image", Point(10, 30),
+            FONT_HERSHEY_SIMPLEX, 1.0, Scalar(255, 255, 255), 2);
+    putText(display, "Features: " + to_string(keypoints.size()), Point(10, 70),
+            FONT_HERSHEY_SIMPLEX, 0.8, Scalar(255, 0, 255), 2);
+    putText(display, "Virtual Object (green)", Point(10, 110),
+            FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0, 255, 0), 2);
+}
+
+// Batch worker: ORB on the image and the static AR overlay, no GUI
+bool processBatchImage(BatchJob &job) {
+    thread_local Ptr<ORB> orb = ORB::create(orbMaxFeatures);
+    Mat gray;
+    cvtColor(job.image, gray, COLOR_BGR2GRAY);
+    vector<KeyPoint> keypoints;
+    Mat descriptors;
+    orb->detectAndCompute(gray, noArray(), keypoints, descriptors);
+    
+    job.info = "features=" + to_string(keypoints.size());
+    if (keypoints.size() < 10) {
+        job.status = "not_enough_features";
+        return false;
+    }
+    drawStaticAR(job.image, keypoints);
+    return true;
+}
+
 int main(int argc, char** argv) {
-    bool staticImageMode = (argc > 1);
+    string targetFile;
+    if (argc > 1 && string(argv[1]) == "--enroll") {
+        if (argc < 4) {
+            cerr << "Usage: " << argv[0] << " --enroll <image> <target.artarget>" << endl;
+            return -1;
+        }
+        return enrollTarget(argv[2], argv[3]);
+    }
+    if (argc > 1 && string(argv[1]) == "--target") {
+        if (argc < 3) {
+            cerr << "Usage: " << argv[0] << " --target <target.artarget>" << endl;
+            return -1;
+        }
+        targetFile = argv[2];
+    }
+    
+    // Texture for the tracked plane: a still image, else a video file
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) != "--texture") continue;
+        Mat texture = imread(argv[i + 1], IMREAD_UNCHANGED);
+        if (texture.empty() && textureVideo.open(argv[i + 1])) textureVideo.read(texture);
+        if (texture.empty()) {
+            cerr << "Error: Could not load texture " << argv[i + 1] << endl;
+            return -1;
+        }
+        planeOverlay.setTexture(texture);
+    }
+    
+    // Batch mode: whole directories or file lists, no GUI
+    string batchSource;
+    BatchOptions batchOptions;
+    if (parseBatchArgs(argc, argv, batchSource, batchOptions)) {
+        vector<string> inputs = collectBatchInputs(batchSource);
+        if (inputs.empty()) {
+            cerr << "Error: No images found in " << batchSource << endl;
+            return -1;
+        }
+        cout << "Processing " << inputs.size() << " images..." << endl;
+        int failures = runBatch(inputs, processBatchImage, batchOptions);
+        cout << "Done: " << inputs.size() - failures << " succeeded, " << failures << " failed" << endl;
+        return failures == 0 ? 0 : 1;
+    }
+    
+    bool staticImageMode = (argc > 1) && argv[1][0] != '-' && targetFile.empty();
     
     if (staticImageMode) {
         
@@ -178,9 +756,21 @@ int main(int argc, char** argv) {
         
         orbDetector = ORB::create(orbMaxFeatures);
         
-        Mat gray;
-        cvtColor(image, gray, COLOR_BGR2GRAY);
-        orbDetector->detectAndCompute(gray, noArray(), referenceKeypoints, referenceDescriptors);
+        // Use the enrolled target if one exists for this image
+        string targetPath = targetPathForImage(argv[1]);
+        bool targetLoaded = filesystem::exists(targetPath) &&
+                            loadTargetFile(targetPath, referenceSize, referenceKeypoints,
+                                           referenceDescriptors) &&
+                            referenceSize == image.size();
+        if (targetLoaded) {
+            cout << "Loaded precomputed target: " << targetPath << endl;
+        } else {
+            referenceDescriptors.release();
+            unmapTarget();
+            Mat gray;
+            cvtColor(image, gray, COLOR_BGR2GRAY);
+            orbDetector->detectAndCompute(gray, noArray(), referenceKeypoints, referenceDescriptors);
+        }
         
         if (referenceKeypoints.size() < 10) {
             cerr << "Error: Not enough features" << endl;
@@ -189,41 +779,7 @@ int main(int argc, char** argv) {
         
         // Draw features and virtual object
         Mat display = image.clone();
-        
-        // Draw detected features
-        for (size_t i = 0; i < min(size_t(100), referenceKeypoints.size()); i++) {
-            circle(display, referenceKeypoints[i].pt, 3, Scalar(255, 0, 255), -1);
-        }
-        
-        // Draw virtual object in center
-        int centerX = image.cols / 2;
-        int centerY = image.rows / 2;
-        int objSize = min(image.cols, image.rows) / 4;
-        
-        vector<Point2f> corners = {
-            Point2f(centerX - objSize, centerY - objSize),
-            Point2f(centerX + objSize, centerY - objSize),
-            Point2f(centerX + objSize, centerY + objSize),
-            Point2f(centerX - objSize, centerY + objSize)
-        };
-        
-        // Draw virtual object (rectangle with diagonals)
-        for (int i = 0; i < 4; i++) {
-            line(display, corners[i], corners[(i + 1) % 4], Scalar(0, 255, 0), 3, LINE_AA);
-        }
-        line(display, corners[0], corners[2], Scalar(0, 255, 0), 2, LINE_AA);
-        line(display, corners[1], corners[3], Scalar(0, 255, 0), 2, LINE_AA);
-        
-        // Draw center point
-        circle(display, Point(centerX, centerY), 10, Scalar(0, 255, 255), -1);
-        
-        // Add text
-        putText(display, "AR Target Image", Point(10, 30),
-                FONT_HERSHEY_SIMPLEX, 1.0, Scalar(255, 255, 255), 2);
-        putText(display, "Features: " + to_string(referenceKeypoints.size()), Point(10, 70),
-                FONT_HERSHEY_SIMPLEX, 0.8, Scalar(255, 0, 255), 2);
-        putText(display, "Virtual Object (green)", Point(10, 110),
-                FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0, 255, 0), 2);
+        drawStaticAR(display, referenceKeypoints);
         
         // Save output
         string outputPath = string(argv[1]);
@@ -249,33 +805,24 @@ int main(int argc, char** argv) {
     // Live camera mode
     printHelp();
     
-    // Scan for available cameras
-    cout << "Scanning for cameras..." << endl;
+    // Scan for available cameras, unless replaying a recording
+    bool replaying = !replayFileFromArgs(argc, argv).empty();
     vector<int> availableCameras;
-    
-    for (int i = 0; i < 5; i++) {
-        VideoCapture testCap(i);
-        if (testCap.isOpened()) {
-            Mat testFrame;
-            testCap >> testFrame;
-            if (!testFrame.empty()) {
-                availableCameras.push_back(i);
-                int width = (int)testCap.get(CAP_PROP_FRAME_WIDTH);
-                int height = (int)testCap.get(CAP_PROP_FRAME_HEIGHT);
-                cout << "  Camera " << i << " - Available (" << width << "x" << height << ")" << endl;
-            }
-            testCap.release();
-        }
+    if (!replaying) {
+        cout << "Scanning for cameras..." << endl;
+        availableCameras = availableCameraIndices(deviceRootFromArgs(argc, argv));
     }
     
-    if (availableCameras.empty()) {
+    if (!replaying && availableCameras.empty()) {
         cerr << "\nERROR: No cameras found!" << endl;
         return -1;
     }
     
     // Ask user to select camera
-    int cameraIndex;
-    if (availableCameras.size() == 1) {
+    int cameraIndex = 0;
+    if (replaying) {
+        // Frames come from the recording
+    } else if (availableCameras.size() == 1) {
         cameraIndex = availableCameras[0];
         cout << "\nUsing camera " << cameraIndex << endl;
     } else {
@@ -294,57 +841,75 @@ int main(int argc, char** argv) {
         }
     }
     
-    // Open selected camera
-    VideoCapture cap(cameraIndex);
-    if (!cap.isOpened()) {
+    // Open selected camera (or the recording)
+    FrameSource cap;
+    if (!cap.open(argc, argv, cameraIndex)) {
         cerr << "Failed to open camera " << cameraIndex << endl;
         return -1;
     }
     
-    cout << "Camera " << cameraIndex << " opened successfully!" << endl;
+    if (!cap.isReplay()) cout << "Camera " << cameraIndex << " opened successfully!" << endl;
     
     // Initialize ORB detector for AR mode
     orbDetector = ORB::create(orbMaxFeatures);
     
+    // Start directly in AR mode on an enrolled target
+    if (!targetFile.empty()) {
+        if (!loadTargetFile(targetFile, referenceSize, referenceKeypoints, referenceDescriptors)) {
+            cerr << "Failed to load target " << targetFile << endl;
+            return -1;
+        }
+        detectionMode = 4;
+        arModeActive = true;
+        resetTracking();
+        cout << "Target loaded: " << referenceKeypoints.size() << " features ("
+             << referenceSize.width << "x" << referenceSize.height << ")" << endl;
+    }
+    
     // Checkerboard parameters (for overlay)
     const int boardWidth = 9;
     const int boardHeight = 6;
     
     int screenshotCount = 0;
+    FramePyramid pyramid;  // Level buffers persist across frames
+    
+    LumaFrame luma;  // Gray taken from the capture buffer before any BGR conversion
+    
+    // Per-mode images and point lists, reused every frame
+    Mat display, harrisImg, orbImg;
+    vector<Point2f> checkerCorners, harrisCorners;
+    
+    FrameScheduler scheduler;
+    scheduler.configure(argc, argv, cap.fps());
+    unique_ptr<BoardDetector> boardDetector =
+        createBoardDetector(argc, argv, CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_FAST_CHECK);
     
     while (true) {
-        Mat frame, gray;
-        cap >> frame;
-        if (frame.empty()) break;
+        cap >> luma;
+        if (luma.empty()) break;
+        scheduler.beginFrame();  // Processing time starts once the frame is in
         
-        // Convert to grayscale
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
+        const Mat &gray = luma.gray();
+        Mat &frame = luma.bgr();
+        pyramid.reset(gray);
         
         // Optionally detect checkerboard for reference
-        vector<Point2f> checkerCorners;
         bool checkerboardFound = false;
         if (showCheckerboard) {
-            checkerboardFound = findChessboardCorners(gray, Size(boardWidth, boardHeight), 
-                                                      checkerCorners,
-                                                      CALIB_CB_ADAPTIVE_THRESH | 
-                                                      CALIB_CB_FAST_CHECK);
-            if (checkerboardFound) {
-                cornerSubPix(gray, checkerCorners, Size(11, 11), Size(-1, -1),
-                            TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.1));
-            }
+            // Smaller pyramid level while frames run over budget
+            boardDetector->setMaxDetectionWidth(scheduler.degraded() ? reducedDetectionWidth(gray.cols)
+                                                                     : DEFAULT_DETECTION_WIDTH);
+            checkerboardFound = boardDetector->detect(pyramid, Size(boardWidth, boardHeight), checkerCorners);
         }
         
-        Mat display;
-        
         if (detectionMode == 4) {
             // AR Mode
-            display = frame.clone();
-            processARMode(display, gray);
+            frame.copyTo(display);
+            processARMode(display, pyramid);
             
         } else if (detectionMode == 1) {
             // Harris Corners only
-            display = frame.clone();
-            vector<Point2f> harrisCorners;
+            frame.copyTo(display);
             detectHarrisCorners(gray, harrisCorners, harrisThreshold);
             drawHarrisCorners(display, harrisCorners);
             
@@ -363,7 +928,7 @@ int main(int argc, char** argv) {
             
         } else if (detectionMode == 2) {
             // ORB Features only
-            display = frame.clone();
+            frame.copyTo(display);
             detectAndDrawORB(display, gray, orbMaxFeatures);
             
             if (showCheckerboard && checkerboardFound) {
@@ -378,11 +943,10 @@ int main(int argc, char** argv) {
             
         } else {
             // Both - split view
-            Mat harrisImg = frame.clone();
-            Mat orbImg = frame.clone();
+            frame.copyTo(harrisImg);
+            frame.copyTo(orbImg);
             
             // Harris on left
-            vector<Point2f> harrisCorners;
             detectHarrisCorners(gray, harrisCorners, harrisThreshold);
             drawHarrisCorners(harrisImg, harrisCorners);
             
@@ -408,9 +972,7 @@ int main(int argc, char** argv) {
             }
             
             // Combine horizontally
-            Mat combined;
-            hconcat(harrisImg, orbImg, combined);
-            display = combined;
+            hconcat(harrisImg, orbImg, display);
         }
         
         // Show the result
@@ -418,7 +980,7 @@ int main(int argc, char** argv) {
         imshow(windowName, display);
         
         // Handle keyboard input
-        char key = (char)waitKey(30);
+        char key = (char)scheduler.waitKey();
         
         if (key == 27) {  // ESC
             break;
@@ -434,13 +996,18 @@ int main(int argc, char** argv) {
         } else if (key == '4') {
             detectionMode = 4;
             arModeActive = false;
+            resetTracking();
             cout << "Mode: AR Mode (press SPACE to capture reference)" << endl;
         } else if (key == ' ') {
             if (detectionMode == 4) {
-                referenceImage = frame.clone();
+                referenceSize = frame.size();
+                // Detach from any mapped target before ORB writes new descriptors
+                referenceDescriptors.release();
+                unmapTarget();
                 orbDetector->detectAndCompute(gray, noArray(), referenceKeypoints, referenceDescriptors);
                 if (!referenceDescriptors.empty()) {
                     arModeActive = true;
+                    resetTracking();
                     cout << "Reference captured! " << referenceKeypoints.size() << " features detected." << endl;
                     cout << "Move camera to see AR tracking..." << endl;
                 } else {
@@ -466,12 +1033,32 @@ int main(int argc, char** argv) {
             orbMaxFeatures = 500;
             orbDetector = ORB::create(orbMaxFeatures);
             arModeActive = false;
+            resetTracking();
             cout << "Reset to defaults" << endl;
         } else if (key == 'c' || key == 'C') {
             showCheckerboard = !showCheckerboard;
             cout << "Checkerboard overlay: " << (showCheckerboard ? "ON" : "OFF") << endl;
         } else if (key == 'h' || key == 'H') {
             printHelp();
+        } else if (key == 't' || key == 'T') {
+            showTexture = !showTexture;
+            cout << "Plane texture: " << (showTexture ? "ON" : "OFF") << endl;
+        } else if (key == 'u' || key == 'U') {
+            useProsac = !useProsac;
+            cout << "Homography estimator: " << (useProsac ? "PROSAC (USAC)" : "RANSAC") << endl;
+        } else if (key == 'm' || key == 'M') {
+            // Record the last match set for offline estimator comparison
+            if (detectionMode == 4 && !lastMatchRefPoints.empty()) {
+                matchSetCount++;
+                string filename = "match_set_" + to_string(matchSetCount) + ".yml";
+                FileStorage fs(filename, FileStorage::WRITE);
+                fs << "ref_points" << lastMatchRefPoints;
+                fs << "curr_points" << lastMatchCurrPoints;
+                fs << "distances" << lastMatchDistances;
+                fs.release();
+                cout << "Match set saved: " << filename << " (" << lastMatchRefPoints.size()
+                     << " matches)" << endl;
+            }
         } else if (key == 'p' || key == 'P') {
             screenshotCount++;
             string filename = "feature_detection_screenshot_" + to_string(screenshotCount) + ".png";
@@ -480,8 +1067,11 @@ int main(int argc, char** argv) {
         }
     }
     
+    cout << "Timing: " << scheduler.summary() << endl;
     cap.release();
     destroyAllWindows();
+    referenceDescriptors.release();
+    unmapTarget();
     
 
     return 0;
@@ -0,0 +1,84 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Frame Pyramid
+ ---------------------------------------------------------
+ * See frame_pyramid.h.
+ */
+
+#include "frame_pyramid.h"
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+FramePyramid::FramePyramid(int maxLevels) : maxLevels_(max(1, maxLevels)) {}
+
+void FramePyramid::reset(const Mat &gray) {
+    // Number of levels that stay at least 16 px on each side
+    int count = 1;
+    Size s = gray.size();
+    while (count < maxLevels_ && s.width >= 32 && s.height >= 32) {
+        s = Size((s.width + 1) / 2, (s.height + 1) / 2);
+        count++;
+    }
+
+    if ((int)levels_.size() != count) {
+        levels_.resize(count);
+        valid_.assign(count, false);
+    }
+    levels_[0] = gray;
+    fill(valid_.begin(), valid_.end(), false);
+    valid_[0] = true;
+    flowValid_ = false;
+}
+
+const Mat &FramePyramid::level(int i) {
+    CV_Assert(!empty() && i >= 0 && i < numLevels());
+    if (!valid_[i]) {
+        const Mat &finer = level(i - 1);
+        // pyrDown reuses the pooled buffer when the size is unchanged
+        pyrDown(finer, levels_[i], Size((finer.cols + 1) / 2, (finer.rows + 1) / 2));
+        valid_[i] = true;
+    }
+    return levels_[i];
+}
+
+int FramePyramid::levelForWidth(int maxWidth) {
+    CV_Assert(!empty());
+    int i = 0;
+    Size s = levels_[0].size();
+    while (s.width > maxWidth && i + 1 < numLevels()) {
+        s = Size((s.width + 1) / 2, (s.height + 1) / 2);
+        i++;
+    }
+    return i;
+}
+
+const vector<Mat> &FramePyramid::opticalFlowPyramid(Size winSize, int maxLevel) {
+    if (flowValid_ && winSize == flowWinSize_ && maxLevel == flowMaxLevel_) return flowLevels_;
+
+    // Keep only levels the LK window still fits into
+    int count = 1;
+    while (count <= maxLevel && count < numLevels()) {
+        Size s = level(count).size();
+        if (s.width <= winSize.width || s.height <= winSize.height) break;
+        count++;
+    }
+
+    flowBuffers_.resize(count);
+    flowLevels_.resize(count);
+    for (int i = 0; i < count; i++) {
+        const Mat &img = level(i);
+        copyMakeBorder(img, flowBuffers_[i], winSize.height, winSize.height,
+                       winSize.width, winSize.width, BORDER_REFLECT_101);
+        flowLevels_[i] = flowBuffers_[i](Rect(winSize.width, winSize.height, img.cols, img.rows));
+    }
+
+    flowValid_ = true;
+    flowWinSize_ = winSize;
+    flowMaxLevel_ = maxLevel;
+    return flowLevels_;
+}
@@ -0,0 +1,57 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Frame Pyramid (shared per-frame image scales)
+ ---------------------------------------------------------
+ * Built once per frame right after cvtColor and handed to every detection
+ * stage, so downsampled copies of the frame are computed at most once.
+ * Level 0 references the grayscale frame; coarser levels are produced by
+ * pyrDown on first use. Level buffers are kept between frames, so a loop
+ * with a fixed capture size does not reallocate them.
+ *
+ * ORB keeps its own internal scale pyramid (OpenCV offers no way to pass one
+ * in); board detection and optical flow draw from this one.
+ */
+
+#ifndef FRAME_PYRAMID_H
+#define FRAME_PYRAMID_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+class FramePyramid {
+public:
+    explicit FramePyramid(int maxLevels = 6);
+
+    // Start a new frame; previously computed levels become stale
+    void reset(const cv::Mat &gray);
+
+    bool empty() const { return levels_.empty() || levels_[0].empty(); }
+    int numLevels() const { return (int)levels_.size(); }
+    cv::Size size() const { return empty() ? cv::Size() : cv::Size(levels_[0].cols, levels_[0].rows); }
+
+    // Level i is (1 / 2^i) of the full frame, computed lazily
+    const cv::Mat &level(int i);
+
+    // Finest level that is at most maxWidth pixels wide
+    int levelForWidth(int maxWidth);
+
+    // Level images with winSize borders, in the layout calcOpticalFlowPyrLK
+    // accepts in place of an image (as from buildOpticalFlowPyramid without
+    // derivatives)
+    const std::vector<cv::Mat> &opticalFlowPyramid(cv::Size winSize, int maxLevel);
+
+private:
+    int maxLevels_;
+    std::vector<cv::Mat> levels_;
+    std::vector<bool> valid_;
+    std::vector<cv::Mat> flowBuffers_;  // Bordered copies, pooled across frames
+    std::vector<cv::Mat> flowLevels_;   // ROIs into flowBuffers_
+    bool flowValid_ = false;
+    cv::Size flowWinSize_;
+    int flowMaxLevel_ = -1;
+};
+
+#endif // FRAME_PYRAMID_H
@@ -0,0 +1,515 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Frame Recording
+ ---------------------------------------------------------
+ * See frame_recording.h.
+ */
+
+#include "frame_recording.h"
+#include "alloc_counter.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+const char FILE_MAGIC[8] = {'C', 'V', 'F', 'R', 'E', 'C', '0', '1'};
+const char INDEX_MAGIC[8] = {'C', 'V', 'F', 'R', 'I', 'D', 'X', '1'};
+const uint32_t CHUNK_MAGIC = 0x4d415246;  // "FRAM"
+const uint32_t FORMAT_VERSION = 1;
+const size_t ALIGNMENT = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t alignment;
+    uint8_t reserved[48];
+};
+
+struct ChunkHeader {
+    uint32_t magic;
+    uint32_t codec;
+    int32_t rows;
+    int32_t cols;
+    int32_t type;
+    uint32_t layout;
+    uint64_t payloadBytes;
+    int64_t timestampUs;
+    uint8_t reserved[24];
+};
+
+struct IndexRecord {
+    uint64_t offset;
+    int64_t timestampUs;
+};
+
+struct Trailer {
+    uint64_t indexOffset;
+    uint64_t frameCount;
+    char magic[8];
+};
+
+static_assert(sizeof(FileHeader) == 64, "file header layout");
+static_assert(sizeof(ChunkHeader) == 64, "chunk header layout");
+static_assert(sizeof(IndexRecord) == 16, "index layout");
+static_assert(sizeof(Trailer) == 24, "trailer layout");
+
+size_t padding(uint64_t bytes) {
+    return (ALIGNMENT - bytes % ALIGNMENT) % ALIGNMENT;
+}
+
+} // namespace
+
+bool FrameRecorder::open(const string &path, FrameCodec codec) {
+    close();
+    file_.open(path, ios::binary | ios::trunc);
+    if (!file_.is_open()) {
+        cerr << "Error: Could not create recording " << path << endl;
+        return false;
+    }
+    codec_ = codec;
+    index_.clear();
+
+    FileHeader header = {};
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.alignment = ALIGNMENT;
+    file_.write((const char *)&header, sizeof(header));
+    offset_ = sizeof(header);
+    return (bool)file_;
+}
+
+bool FrameRecorder::write(const Mat &frame, int64_t timestampUs, PixelLayout layout) {
+    if (!file_.is_open() || frame.empty() || frame.dims > 2) return false;
+
+    ChunkHeader chunk = {};
+    chunk.magic = CHUNK_MAGIC;
+    chunk.codec = (uint32_t)codec_;
+    chunk.rows = frame.rows;
+    chunk.cols = frame.cols;
+    chunk.type = frame.type();
+    chunk.layout = (uint32_t)layout;
+    chunk.timestampUs = timestampUs;
+
+    const size_t rowBytes = frame.cols * frame.elemSize();
+    if (codec_ == FrameCodec::Png) {
+        // PNG has no 2-channel colour type: YUYV is stored as bytes
+        Mat image = frame.channels() == 2 ? frame.reshape(1) : frame;
+        if (!imencode(".png", image, encoded_, {IMWRITE_PNG_COMPRESSION, 1})) return false;
+        chunk.payloadBytes = encoded_.size();
+    } else {
+        chunk.payloadBytes = rowBytes * frame.rows;
+    }
+
+    file_.write((const char *)&chunk, sizeof(chunk));
+    if (codec_ == FrameCodec::Png) {
+        file_.write((const char *)encoded_.data(), encoded_.size());
+    } else if (frame.isContinuous()) {
+        file_.write((const char *)frame.data, chunk.payloadBytes);
+    } else {
+        for (int y = 0; y < frame.rows; y++) file_.write((const char *)frame.ptr(y), rowBytes);
+    }
+    static const char zeros[ALIGNMENT] = {0};
+    size_t pad = padding(chunk.payloadBytes);
+    file_.write(zeros, pad);
+    if (!file_) return false;
+
+    index_.push_back({offset_, timestampUs});
+    offset_ += sizeof(chunk) + chunk.payloadBytes + pad;
+    return true;
+}
+
+void FrameRecorder::close() {
+    if (!file_.is_open()) return;
+    for (const auto &entry : index_) {
+        IndexRecord record = {entry.offset, entry.timestampUs};
+        file_.write((const char *)&record, sizeof(record));
+    }
+    Trailer trailer = {};
+    trailer.indexOffset = offset_;
+    trailer.frameCount = index_.size();
+    memcpy(trailer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    file_.write((const char *)&trailer, sizeof(trailer));
+    file_.close();
+}
+
+bool FrameReplay::open(const string &path) {
+    close();
+    path_ = path;
+    if (!map()) {
+        cerr << "Error: Could not open recording " << path << endl;
+        return false;
+    }
+
+    const FileHeader *header = (const FileHeader *)data_;
+    if (size_ < sizeof(FileHeader) || memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        header->version != FORMAT_VERSION) {
+        cerr << "Error: " << path << " is not a frame recording" << endl;
+        close();
+        return false;
+    }
+
+    if (!loadIndex()) {
+        cerr << "Warning: " << path << " has no index (interrupted recording?), rebuilding" << endl;
+        if (!rebuildIndex()) {
+            close();
+            return false;
+        }
+    }
+    next_ = 0;
+    furthest_ = 0;
+    return true;
+}
+
+void FrameReplay::close() {
+    handedOutBegin_ = handedOutEnd_ = 0;
+    unmap();
+    offsets_.clear();
+    timestamps_.clear();
+    decoded_.release();
+    next_ = 0;
+    furthest_ = 0;
+}
+
+bool FrameReplay::map() {
+#ifndef _WIN32
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    // Private and writable: drawing on a frame copies pages, never the file
+    // (releaseFrame drops the copies again)
+    void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    data_ = (uchar *)p;
+    size_ = (size_t)st.st_size;
+#else
+    ifstream file(path_, ios::binary);
+    if (!file) return false;
+    buffer_.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (buffer_.empty()) return false;
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+    return true;
+}
+
+void FrameReplay::unmap() {
+    if (!data_) return;
+#ifndef _WIN32
+    munmap(data_, size_);
+#else
+    buffer_.clear();
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool FrameReplay::loadIndex() {
+    if (size_ < sizeof(FileHeader) + sizeof(Trailer)) return false;
+    const Trailer *trailer = (const Trailer *)(data_ + size_ - sizeof(Trailer));
+    if (memcmp(trailer->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) return false;
+    uint64_t count = trailer->frameCount;
+    if (trailer->indexOffset > size_ || count > (size_ - trailer->indexOffset) / sizeof(IndexRecord)) return false;
+
+    const IndexRecord *records = (const IndexRecord *)(data_ + trailer->indexOffset);
+    offsets_.resize(count);
+    timestamps_.resize(count);
+    for (uint64_t i = 0; i < count; i++) {
+        if (records[i].offset + sizeof(ChunkHeader) > trailer->indexOffset) return false;
+        offsets_[i] = records[i].offset;
+        timestamps_[i] = records[i].timestampUs;
+    }
+    return true;
+}
+
+bool FrameReplay::rebuildIndex() {
+    offsets_.clear();
+    timestamps_.clear();
+    uint64_t offset = sizeof(FileHeader);
+    while (offset + sizeof(ChunkHeader) <= size_) {
+        const ChunkHeader *chunk = (const ChunkHeader *)(data_ + offset);
+        if (chunk->magic != CHUNK_MAGIC) break;
+        uint64_t end = offset + sizeof(ChunkHeader) + chunk->payloadBytes;
+        if (end > size_) break;  // Truncated last frame
+        offsets_.push_back(offset);
+        timestamps_.push_back(chunk->timestampUs);
+        offset = end + padding(chunk->payloadBytes);
+    }
+    return !offsets_.empty();
+}
+
+// Drop the private copies of the pages of the frame returned last: its
+// drawings are discarded and the pages read from the file if touched again
+void FrameReplay::releaseFrame() {
+#ifndef _WIN32
+    if (handedOutEnd_ > handedOutBegin_) {
+        static const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t begin = handedOutBegin_ / page * page;
+        madvise(data_ + begin, handedOutEnd_ - begin, MADV_DONTNEED);
+    }
+#endif
+    handedOutBegin_ = handedOutEnd_ = 0;
+}
+
+bool FrameReplay::read(Mat &frame, PixelLayout *layout) {
+    if (!data_ || next_ >= offsets_.size()) return false;
+    releaseFrame();
+
+    const ChunkHeader *chunk = (const ChunkHeader *)(data_ + offsets_[next_]);
+    uchar *payload = data_ + offsets_[next_] + sizeof(ChunkHeader);
+    if (chunk->magic != CHUNK_MAGIC || offsets_[next_] + sizeof(ChunkHeader) + chunk->payloadBytes > size_) {
+        cerr << "Error: Corrupt frame " << next_ << " in " << path_ << endl;
+        return false;
+    }
+
+    if (chunk->codec == (uint32_t)FrameCodec::Raw) {
+        Mat view(chunk->rows, chunk->cols, chunk->type, payload);
+        if (view.total() * view.elemSize() != chunk->payloadBytes) return false;
+        frame = view;
+        handedOutBegin_ = payload - data_;
+        handedOutEnd_ = handedOutBegin_ + chunk->payloadBytes;
+    } else {
+        Mat encoded(1, (int)chunk->payloadBytes, CV_8UC1, payload);
+        AllocationScope scope("imdecode");
+        decoded_ = imdecode(encoded, IMREAD_UNCHANGED);
+        if (decoded_.empty()) return false;
+        frame = decoded_.type() == chunk->type ? decoded_ : decoded_.reshape(CV_MAT_CN(chunk->type), chunk->rows);
+        if (frame.type() != chunk->type || frame.cols != chunk->cols) return false;
+    }
+    if (layout) *layout = (PixelLayout)chunk->layout;
+
+    next_++;
+    furthest_ = max(furthest_, next_);
+    return true;
+}
+
+bool FrameReplay::seek(size_t frameIndex) {
+    if (!data_ || frameIndex > offsets_.size()) return false;
+    releaseFrame();
+#ifdef _WIN32
+    // The file was read into memory, so frames already handed out may carry
+    // drawings: read it afresh
+    if (frameIndex < furthest_) {
+        unmap();
+        if (!map()) return false;
+        furthest_ = frameIndex;
+    }
+#endif
+    next_ = frameIndex;
+    return true;
+}
+
+double FrameReplay::fps() const {
+    if (timestamps_.size() < 2) return 0.0;
+    double seconds = (timestamps_.back() - timestamps_.front()) * 1e-6;
+    return seconds > 0 ? (timestamps_.size() - 1) / seconds : 0.0;
+}
+
+bool FrameSource::open(int argc, char **argv, int cameraIndex) {
+    bool realtime = true, luma = false;
+    string recordFile, rawFile;
+    Size rawSize;
+    PixelLayout rawLayout = PixelLayout::Yuyv;
+    FrameCodec codec = FrameCodec::Raw;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--replay-fast") realtime = false;
+        else if (arg == "--record-png") codec = FrameCodec::Png;
+        else if (arg == "--luma") luma = true;
+        else if (arg == "--record" && i + 1 < argc) recordFile = argv[++i];
+        else if (arg == "--replay-raw" && i + 1 < argc) rawFile = argv[++i];
+        else if (arg == "--raw-size" && i + 1 < argc) sscanf(argv[++i], "%dx%d", &rawSize.width, &rawSize.height);
+        else if (arg == "--raw-format" && i + 1 < argc) {
+            string format = argv[++i];
+            if (format == "nv12") rawLayout = PixelLayout::Nv12;
+            else if (format != "yuyv") {
+                cerr << "Error: Unknown raw format " << format << " (yuyv or nv12)" << endl;
+                return false;
+            }
+        }
+    }
+
+    string replayFile = replayFileFromArgs(argc, argv);
+    bool opened;
+    if (!rawFile.empty()) opened = openRawDump(rawFile, rawSize, rawLayout);
+    else if (!replayFile.empty()) opened = openReplay(replayFile, realtime);
+    else opened = openCamera(cameraIndex, luma);
+    if (!opened) return false;
+    if (!recordFile.empty() && !startRecording(recordFile, codec)) return false;
+    return true;
+}
+
+bool FrameSource::openCamera(int cameraIndex, bool luma) {
+    release();
+    if (!camera_.open(cameraIndex)) return false;
+    cameraLayout_ = PixelLayout::Bgr;
+    if (!luma) return true;
+
+    // Ask for YUYV and keep whatever luma format the driver settles on
+    camera_.set(CAP_PROP_FOURCC, VideoWriter::fourcc('Y', 'U', 'Y', 'V'));
+    int fourcc = (int)camera_.get(CAP_PROP_FOURCC);
+    if (fourcc == VideoWriter::fourcc('Y', 'U', 'Y', 'V')) {
+        cameraLayout_ = PixelLayout::Yuyv;
+    } else if (fourcc == VideoWriter::fourcc('N', 'V', '1', '2')) {
+        cameraLayout_ = PixelLayout::Nv12;
+    } else {
+        cerr << "Warning: Camera offers no YUYV/NV12 mode, capturing BGR" << endl;
+        return true;
+    }
+    if (!camera_.set(CAP_PROP_CONVERT_RGB, 0)) {
+        cerr << "Warning: Capture backend always converts to BGR" << endl;
+        cameraLayout_ = PixelLayout::Bgr;
+    }
+    return true;
+}
+
+bool FrameSource::openReplay(const string &path, bool realtime) {
+    release();
+    if (!replay_.open(path)) return false;
+    realtime_ = realtime;
+    expectedFrame_ = SIZE_MAX;
+    cout << "Replaying " << path << ": " << replay_.frameCount() << " frames";
+    if (replay_.fps() > 0) cout << " at " << replay_.fps() << " fps";
+    cout << (realtime ? "" : " (as fast as possible)") << endl;
+    return true;
+}
+
+bool FrameSource::openRawDump(const string &path, Size size, PixelLayout layout) {
+    release();
+    if (size.area() == 0 || layout == PixelLayout::Bgr) {
+        cerr << "Error: Raw dumps need --raw-size WxH and a YUYV/NV12 format" << endl;
+        return false;
+    }
+    rawDump_.open(path, ios::binary);
+    if (!rawDump_.is_open()) {
+        cerr << "Error: Could not open raw dump " << path << endl;
+        return false;
+    }
+    rawSize_ = size;
+    rawLayout_ = layout;
+    rawBuffer_.create(1, (int)rawFrameBytes(size, layout), CV_8UC1);
+    return true;
+}
+
+bool FrameSource::startRecording(const string &path, FrameCodec codec) {
+    if (!recorder_.open(path, codec)) return false;
+    cout << "Recording frames to " << path << endl;
+    return true;
+}
+
+bool FrameSource::isOpened() const {
+    return replay_.isOpened() || rawDump_.is_open() || camera_.isOpened();
+}
+
+double FrameSource::fps() const {
+    if (replay_.isOpened()) return replay_.fps();
+    if (rawDump_.is_open()) return 0.0;
+    return camera_.isOpened() ? camera_.get(CAP_PROP_FPS) : 0.0;
+}
+
+bool FrameSource::readCamera(Mat &raw, PixelLayout &layout) {
+    {
+        AllocationScope scope("VideoCapture::read");
+        if (!camera_.read(cameraBuffer_) || cameraBuffer_.empty()) return false;
+    }
+    layout = cameraLayout_;
+    if (layout == PixelLayout::Bgr) {
+        raw = cameraBuffer_;
+        return true;
+    }
+
+    // Unconverted frames may come as one row of bytes; the size never changes
+    if (cameraSize_.area() == 0) {
+        cameraSize_ = Size((int)camera_.get(CAP_PROP_FRAME_WIDTH), (int)camera_.get(CAP_PROP_FRAME_HEIGHT));
+    }
+    if (wrapRawFrame(cameraBuffer_, cameraSize_, layout, raw)) return true;
+
+    cerr << "Warning: Unexpected raw frame layout, switching to BGR capture" << endl;
+    camera_.set(CAP_PROP_CONVERT_RGB, 1);
+    cameraLayout_ = PixelLayout::Bgr;
+    return readCamera(raw, layout);
+}
+
+bool FrameSource::read(LumaFrame &frame) {
+    Mat raw;
+    PixelLayout layout = PixelLayout::Bgr;
+    int64_t timestampUs;
+    if (replay_.isOpened()) {
+        size_t index = replay_.position();
+        if (index >= replay_.frameCount()) return false;
+        timestampUs = replay_.timestampUs(index);
+
+        // Wait until the frame's time relative to the anchor frame
+        if (realtime_) {
+            if (index != expectedFrame_) {
+                anchorFrame_ = index;
+                anchor_ = Clock::now();
+            } else {
+                auto due = anchor_ + chrono::microseconds(timestampUs - replay_.timestampUs(anchorFrame_));
+                this_thread::sleep_until(due);
+            }
+            expectedFrame_ = index + 1;
+        }
+        if (!replay_.read(raw, &layout)) return false;
+    } else if (rawDump_.is_open()) {
+        // Raw dumps carry no timing: played as fast as possible
+        if (!rawDump_.read((char *)rawBuffer_.data, rawBuffer_.cols)) return false;
+        if (!wrapRawFrame(rawBuffer_, rawSize_, rawLayout_, raw)) return false;
+        layout = rawLayout_;
+        timestampUs = chrono::duration_cast<chrono::microseconds>(Clock::now() - start_).count();
+    } else {
+        if (!readCamera(raw, layout)) return false;
+        timestampUs = chrono::duration_cast<chrono::microseconds>(Clock::now() - start_).count();
+    }
+
+    if (recorder_.isOpened()) recorder_.write(raw, timestampUs, layout);
+    frame.set(raw, layout);
+    return true;
+}
+
+bool FrameSource::read(Mat &frame) {
+    if (!read(scratch_)) return false;
+    frame = scratch_.bgr();
+    return true;
+}
+
+bool FrameSource::set(int propId, double value) {
+    if (isReplay()) return false;
+    return camera_.set(propId, value);
+}
+
+void FrameSource::release() {
+    recorder_.close();
+    replay_.close();
+    rawDump_.close();
+    rawDump_.clear();
+    camera_.release();
+    cameraSize_ = Size();
+    scratch_.release();
+}
+
+string replayFileFromArgs(int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--replay") return argv[i + 1];
+    }
+    return "";
+}
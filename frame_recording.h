@@ -0,0 +1,190 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Frame Recording (record and replay of live capture)
+ ---------------------------------------------------------
+ * Records the exact frames a tool saw so a run can be replayed later, e.g.
+ * to reproduce a performance problem without the camera.
+ *
+ * File layout (.frec, little-endian):
+ *   file header    64 bytes, magic "CVFREC01"
+ *   frame chunks   64-byte header (size, type, pixel layout, codec,
+ *                  capture timestamp)
+ *                  + payload, each chunk padded to 64 bytes
+ *   index          {chunk offset, timestamp} per frame
+ *   trailer        index offset, frame count, magic "CVFRIDX1"
+ * Payloads are raw pixels or PNG (lossless, smaller, slower). A file whose
+ * recording was interrupted has no trailer; its index is rebuilt by walking
+ * the chunks.
+ *
+ * Replay memory-maps the file privately: raw frames are returned as Mat
+ * headers over the mapping without copying. Drawing on such a frame only
+ * copies the touched pages, the file itself is never modified. Those copies
+ * are dropped (madvise) when the next frame is read, so a long replay stays
+ * at about one frame of private memory; the previous frame's pixels remain
+ * readable but its drawings are gone. Frames stay valid until the replay is
+ * closed.
+ *
+ * FrameSource stands in for VideoCapture in the tool loops: a camera, or
+ * --replay <file> (at the recorded timing, or as fast as possible with
+ * --replay-fast), optionally recording everything read with --record <file>
+ * (--record-png for PNG payloads). With --luma the camera is asked for YUYV
+ * (or NV12) without BGR conversion and frames are delivered as LumaFrames
+ * (see luma_frame.h); recordings keep the raw layout. --replay-raw <file>
+ * --raw-size WxH [--raw-format yuyv|nv12] plays a headerless raw dump, e.g.
+ * from v4l2-ctl --stream-to.
+ */
+
+#ifndef FRAME_RECORDING_H
+#define FRAME_RECORDING_H
+
+#include <opencv2/opencv.hpp>
+#include "luma_frame.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class FrameCodec : uint32_t {
+    Raw = 0,
+    Png = 1
+};
+
+class FrameRecorder {
+public:
+    ~FrameRecorder() { close(); }
+
+    bool open(const std::string &path, FrameCodec codec = FrameCodec::Raw);
+    bool isOpened() const { return file_.is_open(); }
+
+    // timestampUs: capture time, microseconds from any fixed origin
+    bool write(const cv::Mat &frame, int64_t timestampUs, PixelLayout layout = PixelLayout::Bgr);
+
+    // Writes the index and trailer
+    void close();
+
+    size_t frameCount() const { return index_.size(); }
+
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        int64_t timestampUs;
+    };
+
+    std::ofstream file_;
+    FrameCodec codec_ = FrameCodec::Raw;
+    uint64_t offset_ = 0;
+    std::vector<IndexEntry> index_;
+    std::vector<uchar> encoded_;  // PNG buffer, reused
+};
+
+class FrameReplay {
+public:
+    FrameReplay() = default;
+    FrameReplay(const FrameReplay &) = delete;
+    FrameReplay &operator=(const FrameReplay &) = delete;
+    ~FrameReplay() { close(); }
+
+    bool open(const std::string &path);
+    bool isOpened() const { return data_ != nullptr; }
+    void close();
+
+    // Next frame; false at the end. Raw frames view the mapping (see above),
+    // PNG frames are decoded into a reused buffer.
+    bool read(cv::Mat &frame, PixelLayout *layout = nullptr);
+    bool seek(size_t frameIndex);
+
+    size_t frameCount() const { return offsets_.size(); }
+    size_t position() const { return next_; }
+    int64_t timestampUs(size_t frameIndex) const { return timestamps_[frameIndex]; }
+
+    // Average rate over the recording, 0 if unknown
+    double fps() const;
+
+private:
+    bool map();
+    void unmap();
+    void releaseFrame();
+    bool loadIndex();
+    bool rebuildIndex();
+
+    std::string path_;
+    uchar *data_ = nullptr;
+    size_t size_ = 0;
+    size_t furthest_ = 0;  // Frames up to here may have been drawn on (no mmap)
+    size_t handedOutBegin_ = 0, handedOutEnd_ = 0;  // Bytes of the last raw frame returned
+    std::vector<uint64_t> offsets_;
+    std::vector<int64_t> timestamps_;
+    size_t next_ = 0;
+    cv::Mat decoded_;
+#ifdef _WIN32
+    std::vector<uchar> buffer_;  // No mmap: the file is read into memory
+#endif
+};
+
+class FrameSource {
+public:
+    // Source options (see above) from the arguments, otherwise the given camera
+    bool open(int argc, char **argv, int cameraIndex = 0);
+    bool openCamera(int cameraIndex, bool luma = false);
+    bool openReplay(const std::string &path, bool realtime = true);
+    bool openRawDump(const std::string &path, cv::Size size, PixelLayout layout);
+    bool startRecording(const std::string &path, FrameCodec codec = FrameCodec::Raw);
+
+    bool isOpened() const;
+    bool isReplay() const { return replay_.isOpened() || rawDump_.is_open(); }
+
+    // Nominal frame rate of the source, 0 if unknown
+    double fps() const;
+
+    // Frame as delivered; gray and BGR are derived on demand
+    bool read(LumaFrame &frame);
+    FrameSource &operator>>(LumaFrame &frame) {
+        if (!read(frame)) frame.release();
+        return *this;
+    }
+
+    // BGR frame, converted if the source is not BGR
+    bool read(cv::Mat &frame);
+    FrameSource &operator>>(cv::Mat &frame) {
+        if (!read(frame)) frame.release();
+        return *this;
+    }
+
+    // Capture properties; ignored during replay
+    bool set(int propId, double value);
+
+    FrameReplay &replay() { return replay_; }
+    void release();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool readCamera(cv::Mat &raw, PixelLayout &layout);
+
+    cv::VideoCapture camera_;
+    PixelLayout cameraLayout_ = PixelLayout::Bgr;
+    cv::Size cameraSize_;
+    cv::Mat cameraBuffer_;
+    FrameReplay replay_;
+    std::ifstream rawDump_;
+    cv::Size rawSize_;
+    PixelLayout rawLayout_ = PixelLayout::Yuyv;
+    cv::Mat rawBuffer_;
+    FrameRecorder recorder_;
+    LumaFrame scratch_;  // For read(Mat &)
+    bool realtime_ = true;
+    // Replay pacing: anchorFrame_ was shown at anchor_; a seek re-anchors
+    size_t anchorFrame_ = 0;
+    size_t expectedFrame_ = SIZE_MAX;
+    Clock::time_point anchor_;
+    Clock::time_point start_ = Clock::now();
+};
+
+// Recording to replay from the arguments (--replay <file>), empty for a camera
+std::string replayFileFromArgs(int argc, char **argv);
+
+#endif // FRAME_RECORDING_H
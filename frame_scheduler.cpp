@@ -0,0 +1,88 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Frame Scheduler
+ ---------------------------------------------------------
+ * See frame_scheduler.h.
+ */
+
+#include "frame_scheduler.h"
+#include "alloc_counter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using namespace cv;
+using namespace std;
+
+void FrameScheduler::configure(int argc, char **argv, double sourceFps) {
+    setSourceFps(sourceFps);
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--fps" && i + 1 < argc) setTargetFps(atof(argv[++i]));
+        else if (arg == "--degrade") degradeOnMiss_ = true;
+    }
+}
+
+void FrameScheduler::setTargetFps(double fps) {
+    targetFps_ = max(0.0, fps);
+    budgetMs_ = 1000.0 / (targetFps_ > 0 ? targetFps_ : sourceFps_);
+}
+
+void FrameScheduler::setSourceFps(double fps) {
+    // Some backends report 0 or nonsense rates
+    sourceFps_ = (fps > 1.0 && fps < 1000.0) ? fps : DEFAULT_SOURCE_FPS;
+    setTargetFps(targetFps_);
+}
+
+void FrameScheduler::beginFrame() {
+    frameStart_ = getTickCount();
+}
+
+int FrameScheduler::finishFrame() {
+    double elapsedMs = (getTickCount() - frameStart_) * 1000.0 / getTickFrequency();
+    lastProcessingMs_ = elapsedMs;
+    missed_ = elapsedMs > budgetMs_;
+
+    frames_++;
+    if (missed_) missedFrames_++;
+    if (degraded_) degradedFrames_++;
+
+    // Degrade on a miss; recover only after a run of comfortable frames
+    if (degradeOnMiss_) {
+        if (missed_) {
+            degraded_ = true;
+            recoveryFrames_ = 0;
+        } else if (degraded_ && elapsedMs < budgetMs_ * DEGRADE_RECOVERY_FRACTION) {
+            if (++recoveryFrames_ >= DEGRADE_RECOVERY_FRAMES) degraded_ = false;
+        } else {
+            recoveryFrames_ = 0;
+        }
+    }
+
+    // The source paces itself unless a target rate was set
+    return targetFps_ > 0 ? max(0, (int)(budgetMs_ - elapsedMs)) : 0;
+}
+
+int FrameScheduler::waitKey() {
+    // waitKey(0) would block: poll for at least 1 ms
+    int delayMs = max(1, finishFrame());
+    AllocationScope scope("waitKey");
+    return cv::waitKey(delayMs);
+}
+
+void FrameScheduler::endFrame() {
+    int waitMs = finishFrame();
+    if (waitMs > 0) this_thread::sleep_for(chrono::milliseconds(waitMs));
+}
+
+string FrameScheduler::summary() const {
+    char text[160];
+    snprintf(text, sizeof(text), "%d frames, %d over the %.1f ms budget, %d degraded",
+             frames_, missedFrames_, budgetMs_, degradedFrames_);
+    return text;
+}
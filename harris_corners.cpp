@@ -0,0 +1,52 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Harris Corners
+ ---------------------------------------------------------
+ * See harris_corners.h.
+ */
+
+#include "harris_corners.h"
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+void detectHarrisCorners(const Mat &gray, vector<Point2f> &corners, double threshold) {
+    Mat dst, dst_norm;
+    
+    cornerHarris(gray, dst, 2, 3, 0.04);
+    
+    // Normalize
+    normalize(dst, dst_norm, 0, 255, NORM_MINMAX, CV_32FC1, Mat());
+    
+    // Threshold and find local maxima
+    corners.clear();
+    for (int j = 0; j < dst_norm.rows; j++) {
+        for (int i = 0; i < dst_norm.cols; i++) {
+            if ((float)dst_norm.at<float>(j, i) > threshold * 255) {
+                corners.push_back(Point2f(i, j));
+            }
+        }
+    }
+    
+    // Non-maximum suppression (simple version)
+    if (corners.size() > MAX_HARRIS_CORNERS) {
+        // Sort by response strength
+        vector<pair<float, Point2f>> scored;
+        for (const auto &pt : corners) {
+            scored.push_back({dst_norm.at<float>(pt.y, pt.x), pt});
+        }
+        // Sort by first element (response strength) in descending order
+        sort(scored.begin(), scored.end(), [](const pair<float, Point2f>& a, const pair<float, Point2f>& b) {
+            return a.first > b.first;  // Greater response first
+        });
+        
+        corners.clear();
+        for (size_t i = 0; i < min(MAX_HARRIS_CORNERS, scored.size()); i++) {
+            corners.push_back(scored[i].second);
+        }
+    }
+}
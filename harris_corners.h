@@ -0,0 +1,23 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Harris Corners (shared by feature_detection and the kernel benchmark)
+ ---------------------------------------------------------
+ * cornerHarris response, normalized to 0..255 and thresholded; when more
+ * than MAX_HARRIS_CORNERS pass, only the strongest are kept.
+ */
+
+#ifndef HARRIS_CORNERS_H
+#define HARRIS_CORNERS_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+const size_t MAX_HARRIS_CORNERS = 1000;
+
+// threshold is a fraction of the strongest response (0..1)
+void detectHarrisCorners(const cv::Mat &gray, std::vector<cv::Point2f> &corners, double threshold);
+
+#endif // HARRIS_CORNERS_H
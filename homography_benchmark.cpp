@@ -0,0 +1,300 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Homography Estimator Benchmark (Extension)
+ ---------------------------------------------------------
+ * Compares plain RANSAC against PROSAC/USAC with local optimization on match
+ * sets recorded from feature_detection (key 'm' in AR mode). Each match set
+ * stores reference/current points ordered by descriptor distance.
+ *
+ * Both estimators are the ones feature_detection calls (findHomographyRobust).
+ *
+ * Reports median latency, inlier count and iterations to reach a solution
+ * for each estimator. OpenCV does not report the iterations it ran, so they
+ * are measured with a minimal sample-and-verify loop over the same ordered
+ * matches: uniform samples (RANSAC) or PROSAC's progressive samples from the
+ * best-ranked prefix, each fitted with getPerspectiveTransform and verified
+ * against all matches, until a model reaches SOLUTION_INLIER_FRACTION of the
+ * best inlier count (median over the repeats). The modelled bounds (RANSAC
+ * stopping rule, PROSAC growth schedule) are printed next to them.
+ *
+ * Usage: homography_benchmark match_set_1.yml [match_set_2.yml ...] [--repeats N]
+ */
+
+#include <opencv2/opencv.hpp>
+#include "homography_estimation.h"
+#include <iostream>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+// Estimator settings are feature_detection's (homography_estimation.h)
+const double REPROJ_THRESHOLD = HOMOGRAPHY_REPROJ_THRESHOLD;
+const double CONFIDENCE = HOMOGRAPHY_CONFIDENCE;
+const int SAMPLE_SIZE = 4;
+const double MAX_ITERATIONS = HOMOGRAPHY_MAX_ITERATIONS;
+const double SOLUTION_INLIER_FRACTION = 0.8;  // Of the best model's inliers
+
+struct MatchSet {
+    string name;
+    vector<Point2f> refPoints;
+    vector<Point2f> currPoints;
+};
+
+// Load a match set written by feature_detection
+bool loadMatchSet(const string &filename, MatchSet &set) {
+    FileStorage fs(filename, FileStorage::READ);
+    if (!fs.isOpened()) {
+        cerr << "Failed to open match set: " << filename << endl;
+        return false;
+    }
+    fs["ref_points"] >> set.refPoints;
+    fs["curr_points"] >> set.currPoints;
+    fs.release();
+    set.name = filename;
+    return set.refPoints.size() == set.currPoints.size() && set.refPoints.size() >= (size_t)SAMPLE_SIZE;
+}
+
+// Mark correspondences that agree with H within the reprojection threshold
+vector<bool> classifyInliers(const MatchSet &set, const Mat &H) {
+    vector<bool> inlier(set.refPoints.size(), false);
+    if (H.empty()) return inlier;
+    vector<Point2f> projected;
+    perspectiveTransform(set.refPoints, projected, H);
+    for (size_t i = 0; i < projected.size(); i++) {
+        Point2f d = projected[i] - set.currPoints[i];
+        inlier[i] = (d.x * d.x + d.y * d.y) < REPROJ_THRESHOLD * REPROJ_THRESHOLD;
+    }
+    return inlier;
+}
+
+// Standard RANSAC stopping bound for inlier ratio w
+double ransacIterations(double w) {
+    if (w <= 0.0) return MAX_ITERATIONS;
+    double allInlier = pow(w, SAMPLE_SIZE);
+    if (allInlier >= 1.0) return 1.0;
+    return min(MAX_ITERATIONS, ceil(log(1.0 - CONFIDENCE) / log(1.0 - allInlier)));
+}
+
+// PROSAC: samples are drawn from the top-n matches, with n growing on the
+// schedule T'_n. Solution is expected once the prefix is clean enough, so the
+// cost is the best T'_n + RANSAC bound on that prefix.
+double prosacIterations(const vector<bool> &inlier) {
+    const int N = (int)inlier.size();
+    double Tn = MAX_ITERATIONS;
+    for (int i = 0; i < SAMPLE_SIZE; i++) {
+        Tn *= (double)(SAMPLE_SIZE - i) / (N - i);
+    }
+    double TnPrime = 1.0;
+    int prefixInliers = 0;
+    for (int i = 0; i < SAMPLE_SIZE; i++) prefixInliers += inlier[i];
+
+    double best = TnPrime + ransacIterations((double)prefixInliers / SAMPLE_SIZE);
+    for (int n = SAMPLE_SIZE; n < N; n++) {
+        double TnNext = Tn * (n + 1) / (n + 1 - SAMPLE_SIZE);
+        TnPrime += ceil(TnNext - Tn);
+        Tn = TnNext;
+        prefixInliers += inlier[n];
+        best = min(best, TnPrime + ransacIterations((double)prefixInliers / (n + 1)));
+    }
+    return min(best, MAX_ITERATIONS);
+}
+
+// Correspondences within the reprojection threshold of H
+int countInliers(const MatchSet &set, const Matx33d &H) {
+    int count = 0;
+    for (size_t i = 0; i < set.refPoints.size(); i++) {
+        const Point2f &p = set.refPoints[i];
+        double w = H(2, 0) * p.x + H(2, 1) * p.y + H(2, 2);
+        if (fabs(w) < 1e-12) continue;
+        double dx = (H(0, 0) * p.x + H(0, 1) * p.y + H(0, 2)) / w - set.currPoints[i].x;
+        double dy = (H(1, 0) * p.x + H(1, 1) * p.y + H(1, 2)) / w - set.currPoints[i].y;
+        count += dx * dx + dy * dy < REPROJ_THRESHOLD * REPROJ_THRESHOLD;
+    }
+    return count;
+}
+
+// Draw k distinct indices from [0, n) into out
+void sampleDistinct(RNG &rng, int n, int k, int *out) {
+    for (int i = 0; i < k; i++) {
+        bool repeated;
+        do {
+            out[i] = rng.uniform(0, n);
+            repeated = find(out, out + i, out[i]) != out + i;
+        } while (repeated);
+    }
+}
+
+// Minimal sample-and-verify loop: model evaluations until one reaches
+// `target` inliers (MAX_ITERATIONS if none does). progressive draws samples
+// as PROSAC does, from a best-ranked prefix growing on the schedule T'_n.
+int measureIterations(const MatchSet &set, int target, bool progressive, RNG &rng) {
+    const int N = (int)set.refPoints.size();
+    int n = SAMPLE_SIZE;
+    double Tn = MAX_ITERATIONS;
+    for (int i = 0; i < SAMPLE_SIZE; i++) Tn *= (double)(SAMPLE_SIZE - i) / (N - i);
+    double TnPrime = 1.0;
+
+    int sample[SAMPLE_SIZE];
+    Point2f src[SAMPLE_SIZE], dst[SAMPLE_SIZE];
+    for (int t = 1; t <= (int)MAX_ITERATIONS; t++) {
+        if (!progressive) {
+            sampleDistinct(rng, N, SAMPLE_SIZE, sample);
+        } else {
+            while (t > TnPrime && n < N) {
+                double TnNext = Tn * (n + 1) / (n + 1 - SAMPLE_SIZE);
+                TnPrime += ceil(TnNext - Tn);
+                Tn = TnNext;
+                n++;
+            }
+            // Samples up to T'_n include the newest match of the prefix;
+            // past the last growth step they are uniform over all matches
+            if (t <= TnPrime) {
+                sampleDistinct(rng, n - 1, SAMPLE_SIZE - 1, sample);
+                sample[SAMPLE_SIZE - 1] = n - 1;
+            } else {
+                sampleDistinct(rng, n, SAMPLE_SIZE, sample);
+            }
+        }
+        for (int i = 0; i < SAMPLE_SIZE; i++) {
+            src[i] = set.refPoints[sample[i]];
+            dst[i] = set.currPoints[sample[i]];
+        }
+        Mat H = getPerspectiveTransform(src, dst);
+        if (!H.empty() && countInliers(set, Matx33d(H)) >= target) return t;
+    }
+    return (int)MAX_ITERATIONS;
+}
+
+// Median of measureIterations over several seeded runs
+double medianIterations(const MatchSet &set, int target, bool progressive, int repeats) {
+    RNG rng(0x5eed);
+    vector<int> runs;
+    for (int r = 0; r < repeats; r++) runs.push_back(measureIterations(set, target, progressive, rng));
+    sort(runs.begin(), runs.end());
+    return runs[runs.size() / 2];
+}
+
+// Time an estimator over several repeats and report the median
+template <typename Estimator>
+double medianLatencyMs(Estimator estimate, int repeats, Mat &H, Mat &mask) {
+    vector<double> times;
+    for (int r = 0; r < repeats; r++) {
+        int64 start = getTickCount();
+        H = estimate(mask);
+        times.push_back((getTickCount() - start) * 1000.0 / getTickFrequency());
+    }
+    sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    vector<string> files;
+    int repeats = 50;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--repeats" && i + 1 < argc) {
+            repeats = max(1, atoi(argv[++i]));
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        cerr << "Usage: " << argv[0] << " match_set_1.yml [...] [--repeats N]" << endl;
+        return -1;
+    }
+
+    cout << "\n" << string(80, '=') << endl;
+    cout << "HOMOGRAPHY ESTIMATOR BENCHMARK (" << repeats << " repeats)" << endl;
+    cout << string(80, '=') << endl;
+    cout << left << setw(24) << "Match set"
+         << setw(8) << "N"
+         << setw(10) << "Method"
+         << setw(12) << "Median ms"
+         << setw(10) << "Inliers"
+         << setw(10) << "Iters"
+         << setw(12) << "Modelled" << endl;
+    cout << string(80, '-') << endl;
+
+    double totalRansacMs = 0, totalProsacMs = 0;
+    double totalRansacIters = 0, totalProsacIters = 0;
+    double totalRansacModel = 0, totalProsacModel = 0;
+    int numSets = 0;
+
+    for (const auto &file : files) {
+        MatchSet set;
+        if (!loadMatchSet(file, set)) {
+            cerr << "Skipping " << file << endl;
+            continue;
+        }
+
+        Mat ransacH, ransacMask, prosacH, prosacMask;
+        double ransacMs = medianLatencyMs([&](Mat &mask) {
+            return findHomographyRobust(set.refPoints, set.currPoints, mask, false);
+        }, repeats, ransacH, ransacMask);
+        double prosacMs = medianLatencyMs([&](Mat &mask) {
+            return findHomographyRobust(set.refPoints, set.currPoints, mask, true);
+        }, repeats, prosacH, prosacMask);
+
+        // Label inliers with the better of the two models
+        vector<bool> ransacInliers = classifyInliers(set, ransacH);
+        vector<bool> prosacInliers = classifyInliers(set, prosacH);
+        int ransacCount = (int)count(ransacInliers.begin(), ransacInliers.end(), true);
+        int prosacCount = (int)count(prosacInliers.begin(), prosacInliers.end(), true);
+        const vector<bool> &truth = (prosacCount > ransacCount) ? prosacInliers : ransacInliers;
+        int truthCount = max(ransacCount, prosacCount);
+
+        double ransacModel = ransacIterations((double)truthCount / set.refPoints.size());
+        double prosacModel = prosacIterations(truth);
+        int target = max(SAMPLE_SIZE, (int)ceil(SOLUTION_INLIER_FRACTION * truthCount));
+        double ransacIters = medianIterations(set, target, false, repeats);
+        double prosacIters = medianIterations(set, target, true, repeats);
+
+        string shortName = set.name.substr(set.name.find_last_of("/\\") + 1);
+        cout << left << setw(24) << shortName.substr(0, 23)
+             << setw(8) << set.refPoints.size()
+             << setw(10) << "RANSAC"
+             << setw(12) << fixed << setprecision(3) << ransacMs
+             << setw(10) << ransacCount
+             << setw(10) << setprecision(0) << ransacIters
+             << setw(12) << ransacModel << endl;
+        cout << left << setw(24) << ""
+             << setw(8) << ""
+             << setw(10) << "PROSAC"
+             << setw(12) << fixed << setprecision(3) << prosacMs
+             << setw(10) << prosacCount
+             << setw(10) << setprecision(0) << prosacIters
+             << setw(12) << prosacModel << endl;
+
+        totalRansacMs += ransacMs;
+        totalProsacMs += prosacMs;
+        totalRansacIters += ransacIters;
+        totalProsacIters += prosacIters;
+        totalRansacModel += ransacModel;
+        totalProsacModel += prosacModel;
+        numSets++;
+    }
+
+    if (numSets == 0) {
+        cerr << "\nNo valid match sets" << endl;
+        return -1;
+    }
+
+    cout << string(80, '-') << endl;
+    cout << "Mean latency:    RANSAC " << fixed << setprecision(3) << totalRansacMs / numSets
+         << " ms, PROSAC " << totalProsacMs / numSets << " ms" << endl;
+    cout << "Mean iterations: RANSAC " << setprecision(1) << totalRansacIters / numSets
+         << ", PROSAC " << totalProsacIters / numSets << " (measured, median of " << repeats << " runs)" << endl;
+    cout << "Mean modelled:   RANSAC " << totalRansacModel / numSets
+         << ", PROSAC " << totalProsacModel / numSets << " (bounds from the inlier ratios)" << endl;
+    cout << string(80, '=') << endl;
+
+    return 0;
+}
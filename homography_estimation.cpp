@@ -0,0 +1,40 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Homography Estimation
+ ---------------------------------------------------------
+ * See homography_estimation.h.
+ */
+
+#include "homography_estimation.h"
+
+using namespace cv;
+using namespace std;
+
+UsacParams prosacHomographyParams() {
+    UsacParams params;
+    params.sampler = SAMPLING_PROSAC;
+    params.score = SCORE_METHOD_MSAC;
+    params.loMethod = LOCAL_OPTIM_INNER_LO;
+    params.loIterations = 10;
+    params.loSampleSize = 14;
+    params.neighborsSearch = NEIGH_GRID;
+    params.threshold = HOMOGRAPHY_REPROJ_THRESHOLD;
+    params.confidence = HOMOGRAPHY_CONFIDENCE;
+    params.maxIterations = HOMOGRAPHY_MAX_ITERATIONS;
+    params.isParallel = false;
+    params.randomGeneratorState = 0;
+    return params;
+}
+
+// LO refines the best model from its inlier set
+Mat findHomographyRobust(const vector<Point2f> &refPoints, const vector<Point2f> &currPoints,
+                         Mat &inlierMask, bool prosac) {
+    if (!prosac) {
+        return findHomography(refPoints, currPoints, RANSAC, HOMOGRAPHY_REPROJ_THRESHOLD, inlierMask,
+                              HOMOGRAPHY_MAX_ITERATIONS, HOMOGRAPHY_CONFIDENCE);
+    }
+    return findHomography(refPoints, currPoints, inlierMask, prosacHomographyParams());
+}
@@ -0,0 +1,33 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Homography Estimation (shared by feature_detection and the benchmarks)
+ ---------------------------------------------------------
+ * The robust estimator settings live here so homography_benchmark and
+ * kernel_benchmark time exactly what feature_detection runs: PROSAC sampling
+ * (correspondences ordered best-first, adaptive termination) with MSAC
+ * scoring and inner local optimization, or plain RANSAC for comparison.
+ */
+
+#ifndef HOMOGRAPHY_ESTIMATION_H
+#define HOMOGRAPHY_ESTIMATION_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+const double HOMOGRAPHY_REPROJ_THRESHOLD = 3.0;  // px
+const double HOMOGRAPHY_CONFIDENCE = 0.995;
+const int HOMOGRAPHY_MAX_ITERATIONS = 2000;
+
+// USAC settings of the PROSAC estimator
+cv::UsacParams prosacHomographyParams();
+
+// Homography from refPoints to currPoints with inlierMask; PROSAC expects the
+// correspondences ordered best-first, prosac = false runs plain RANSAC
+cv::Mat findHomographyRobust(const std::vector<cv::Point2f> &refPoints,
+                             const std::vector<cv::Point2f> &currPoints,
+                             cv::Mat &inlierMask, bool prosac = true);
+
+#endif // HOMOGRAPHY_ESTIMATION_H
@@ -0,0 +1,361 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Intrinsics Store
+ ---------------------------------------------------------
+ * File layout (little-endian):
+ *   StoreHeader
+ *   uint32 buckets[numBuckets]   entry index + 1, 0 = empty (power-of-two table)
+ *   StoreEntry entries[numEntries]
+ *
+ * Every entry is inserted under (id, width, height) and, for the first entry
+ * of each id, also under (id, 0, 0) so "any resolution" stays a single probe.
+ */
+
+#include "intrinsics_store.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+const char STORE_MAGIC[8] = {'I', 'N', 'T', 'R', 'S', 'T', 'R', '1'};
+const uint32_t STORE_VERSION = 1;
+const int MAX_ID_LENGTH = 47;
+const int MAX_DIST_COEFFS = 14;
+
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t numBuckets;
+    uint32_t reserved;
+    uint64_t bucketsOffset;
+    uint64_t entriesOffset;
+};
+
+struct StoreEntry {
+    char cameraId[MAX_ID_LENGTH + 1];
+    int32_t width;
+    int32_t height;
+    int32_t numDistCoeffs;
+    int32_t reserved;
+    double cameraMatrix[9];
+    double distCoeffs[MAX_DIST_COEFFS];
+    double reprojectionError;
+};
+
+// FNV-1a over id and resolution
+uint64_t hashKey(const string &cameraId, int width, int height) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const void *p, size_t n) {
+        const uint8_t *bytes = (const uint8_t*)p;
+        for (size_t i = 0; i < n; i++) {
+            h ^= bytes[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(cameraId.data(), cameraId.size());
+    int32_t dims[2] = {width, height};
+    mix(dims, sizeof(dims));
+    return h;
+}
+
+StoreEntry packEntry(const CameraIntrinsics &intr) {
+    StoreEntry e = {};
+    strncpy(e.cameraId, intr.cameraId.c_str(), MAX_ID_LENGTH);
+    e.width = intr.imageSize.width;
+    e.height = intr.imageSize.height;
+    Mat K, D;
+    intr.cameraMatrix.convertTo(K, CV_64F);
+    intr.distCoeffs.reshape(1, (int)intr.distCoeffs.total()).convertTo(D, CV_64F);
+    for (int i = 0; i < 9; i++) e.cameraMatrix[i] = K.at<double>(i / 3, i % 3);
+    e.numDistCoeffs = min((int)D.total(), MAX_DIST_COEFFS);
+    for (int i = 0; i < e.numDistCoeffs; i++) e.distCoeffs[i] = D.at<double>(i);
+    e.reprojectionError = intr.reprojectionError;
+    return e;
+}
+
+CameraIntrinsics unpackEntry(const StoreEntry &e) {
+    CameraIntrinsics intr;
+    intr.cameraId = string(e.cameraId, strnlen(e.cameraId, MAX_ID_LENGTH));
+    intr.imageSize = Size(e.width, e.height);
+    intr.cameraMatrix = Mat(3, 3, CV_64F, (void*)e.cameraMatrix).clone();
+    intr.distCoeffs = Mat(e.numDistCoeffs, 1, CV_64F, (void*)e.distCoeffs).clone();
+    intr.reprojectionError = e.reprojectionError;
+    return intr;
+}
+
+} // namespace
+
+IntrinsicsStore::~IntrinsicsStore() {
+    close();
+}
+
+bool IntrinsicsStore::open(const string &filename) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(StoreHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) return false;
+    data_ = (const uint8_t*)addr;
+    size_ = st.st_size;
+#else
+    ifstream in(filename, ios::binary | ios::ate);
+    if (!in) return false;
+    buffer_.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char*)buffer_.data(), buffer_.size());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    const StoreHeader &header = *(const StoreHeader*)data_;
+    bool valid = size_ >= sizeof(StoreHeader) &&
+                 memcmp(header.magic, STORE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == STORE_VERSION &&
+                 header.numBuckets > 0 && (header.numBuckets & (header.numBuckets - 1)) == 0 &&
+                 header.bucketsOffset + (uint64_t)header.numBuckets * sizeof(uint32_t) <= size_ &&
+                 header.entriesOffset + (uint64_t)header.numEntries * sizeof(StoreEntry) <= size_;
+    if (!valid) {
+        cerr << "Invalid intrinsics store: " << filename << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void IntrinsicsStore::close() {
+#ifndef _WIN32
+    if (data_ && buffer_.empty()) munmap((void*)data_, size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+size_t IntrinsicsStore::size() const {
+    return data_ ? ((const StoreHeader*)data_)->numEntries : 0;
+}
+
+CameraIntrinsics IntrinsicsStore::entry(size_t index) const {
+    const StoreHeader &header = *(const StoreHeader*)data_;
+    const StoreEntry *entries = (const StoreEntry*)(data_ + header.entriesOffset);
+    return unpackEntry(entries[index]);
+}
+
+bool IntrinsicsStore::find(const string &cameraId, Size imageSize, CameraIntrinsics &out) const {
+    if (!data_) return false;
+    const StoreHeader &header = *(const StoreHeader*)data_;
+    const uint32_t *buckets = (const uint32_t*)(data_ + header.bucketsOffset);
+    const StoreEntry *entries = (const StoreEntry*)(data_ + header.entriesOffset);
+    bool anySize = imageSize.area() == 0;
+
+    uint32_t mask = header.numBuckets - 1;
+    uint64_t h = hashKey(cameraId, anySize ? 0 : imageSize.width, anySize ? 0 : imageSize.height);
+    for (uint32_t probe = 0; probe < header.numBuckets; probe++) {
+        uint32_t slot = buckets[(h + probe) & mask];
+        if (slot == 0) return false;
+        if (slot > header.numEntries) return false;
+        const StoreEntry &e = entries[slot - 1];
+        if (strncmp(e.cameraId, cameraId.c_str(), MAX_ID_LENGTH + 1) == 0 &&
+            (anySize || (e.width == imageSize.width && e.height == imageSize.height))) {
+            out = unpackEntry(e);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IntrinsicsStore::write(const string &filename, const vector<CameraIntrinsics> &entries) {
+    StoreHeader header = {};
+    memcpy(header.magic, STORE_MAGIC, sizeof(header.magic));
+    header.version = STORE_VERSION;
+    header.numEntries = (uint32_t)entries.size();
+    header.numBuckets = 16;
+    while (header.numBuckets < 4 * max<size_t>(entries.size(), 1)) header.numBuckets *= 2;
+    header.bucketsOffset = sizeof(StoreHeader);
+    header.entriesOffset = header.bucketsOffset + header.numBuckets * sizeof(uint32_t);
+
+    vector<uint32_t> buckets(header.numBuckets, 0);
+    auto insert = [&](uint64_t h, uint32_t slot) {
+        uint32_t mask = header.numBuckets - 1;
+        for (uint32_t probe = 0; probe < header.numBuckets; probe++) {
+            uint32_t &b = buckets[(h + probe) & mask];
+            if (b == 0) {
+                b = slot;
+                return;
+            }
+        }
+    };
+
+    vector<StoreEntry> packed;
+    vector<string> seenIds;
+    for (size_t i = 0; i < entries.size(); i++) {
+        const CameraIntrinsics &intr = entries[i];
+        if (intr.cameraId.empty() || (int)intr.cameraId.size() > MAX_ID_LENGTH) {
+            cerr << "Invalid camera id for intrinsics store: '" << intr.cameraId << "'" << endl;
+            return false;
+        }
+        packed.push_back(packEntry(intr));
+        insert(hashKey(intr.cameraId, intr.imageSize.width, intr.imageSize.height), (uint32_t)i + 1);
+        if (std::find(seenIds.begin(), seenIds.end(), intr.cameraId) == seenIds.end()) {
+            insert(hashKey(intr.cameraId, 0, 0), (uint32_t)i + 1);
+            seenIds.push_back(intr.cameraId);
+        }
+    }
+
+    // Write to a temporary file first so readers never see a partial store
+    string tmp = filename + ".tmp";
+    {
+        ofstream out(tmp, ios::binary);
+        if (!out) return false;
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)buckets.data(), buckets.size() * sizeof(uint32_t));
+        out.write((const char*)packed.data(), packed.size() * sizeof(StoreEntry));
+        if (!out) return false;
+    }
+    error_code ec;
+    filesystem::rename(tmp, filename, ec);
+    return !ec;
+}
+
+bool upsertIntrinsics(const string &storeFile, const CameraIntrinsics &intrinsics) {
+    vector<CameraIntrinsics> entries;
+    {
+        IntrinsicsStore store;
+        if (store.open(storeFile)) {
+            for (size_t i = 0; i < store.size(); i++) {
+                CameraIntrinsics e = store.entry(i);
+                if (e.cameraId != intrinsics.cameraId || e.imageSize != intrinsics.imageSize) {
+                    entries.push_back(e);
+                }
+            }
+        }
+    }
+    entries.push_back(intrinsics);
+    return IntrinsicsStore::write(storeFile, entries);
+}
+
+bool readIntrinsicsYaml(const string &filename, CameraIntrinsics &intrinsics) {
+    FileStorage fs(filename, FileStorage::READ);
+    if (!fs.isOpened()) return false;
+    if (!fs["camera_id"].empty()) fs["camera_id"] >> intrinsics.cameraId;
+    fs["camera_matrix"] >> intrinsics.cameraMatrix;
+    fs["distortion_coefficients"] >> intrinsics.distCoeffs;
+    int width = 0, height = 0;
+    if (!fs["image_width"].empty()) fs["image_width"] >> width;
+    if (!fs["image_height"].empty()) fs["image_height"] >> height;
+    intrinsics.imageSize = Size(width, height);
+    if (!fs["reprojection_error"].empty()) {
+        fs["reprojection_error"] >> intrinsics.reprojectionError;
+    } else if (!fs["overall_rmse"].empty()) {
+        fs["overall_rmse"] >> intrinsics.reprojectionError;
+    }
+    fs.release();
+    return !intrinsics.cameraMatrix.empty();
+}
+
+bool writeIntrinsicsYaml(const string &filename, const CameraIntrinsics &intrinsics) {
+    FileStorage fs(filename, FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+    fs << "camera_id" << intrinsics.cameraId;
+    fs << "image_width" << intrinsics.imageSize.width;
+    fs << "image_height" << intrinsics.imageSize.height;
+    fs << "camera_matrix" << intrinsics.cameraMatrix;
+    fs << "distortion_coefficients" << intrinsics.distCoeffs;
+    fs << "reprojection_error" << intrinsics.reprojectionError;
+    fs.release();
+    return true;
+}
+
+// Entry of cameraId to scale to frameSize: the largest calibration with the
+// same aspect ratio, else the largest one
+static bool closestResolution(const IntrinsicsStore &store, const string &cameraId, Size frameSize,
+                              CameraIntrinsics &out) {
+    bool found = false, foundSameAspect = false;
+    for (size_t i = 0; i < store.size(); i++) {
+        CameraIntrinsics e = store.entry(i);
+        if (e.cameraId != cameraId) continue;
+        bool sameAspect = (int64_t)e.imageSize.width * frameSize.height ==
+                          (int64_t)e.imageSize.height * frameSize.width;
+        bool better = !found || (sameAspect && !foundSameAspect) ||
+                      (sameAspect == foundSameAspect && e.imageSize.area() > out.imageSize.area());
+        if (better) {
+            out = e;
+            found = true;
+            foundSameAspect = sameAspect;
+        }
+    }
+    return found;
+}
+
+bool loadCameraIntrinsics(const IntrinsicsStore &store, const string &cameraId, Size imageSize,
+                          CameraIntrinsics &intrinsics, const string &yamlFile) {
+    if (store.find(cameraId, imageSize, intrinsics)) return true;
+    // No calibration at this resolution: one to rescale (scaledCameraMatrix)
+    if (imageSize.area() > 0 && closestResolution(store, cameraId, imageSize, intrinsics)) return true;
+
+    // The YAML file holds one camera: the default one unless it names another
+    CameraIntrinsics yaml;
+    if (readIntrinsicsYaml(yamlFile, yaml)) {
+        if (yaml.cameraId.empty()) yaml.cameraId = DEFAULT_CAMERA_ID;
+        if (yaml.cameraId == cameraId) {
+            intrinsics = yaml;
+            return true;
+        }
+        cerr << "No calibration for " << cameraId << ": " << yamlFile << " belongs to " << yaml.cameraId
+             << ", not using it" << endl;
+        return false;
+    }
+    cerr << "Failed to load camera parameters for " << cameraId << " (file: " << yamlFile << ")" << endl;
+    return false;
+}
+
+bool loadCameraIntrinsics(const string &cameraId, Size imageSize, CameraIntrinsics &intrinsics,
+                          const string &storeFile, const string &yamlFile) {
+    IntrinsicsStore store;
+    if (!store.open(storeFile)) cerr << "No intrinsics store " << storeFile << ", trying " << yamlFile << endl;
+    return loadCameraIntrinsics(store, cameraId, imageSize, intrinsics, yamlFile);
+}
+
+Mat scaledCameraMatrix(const CameraIntrinsics &intrinsics, Size frameSize) {
+    Mat K = intrinsics.cameraMatrix.clone();
+    if (intrinsics.imageSize.area() == 0 || frameSize == intrinsics.imageSize) return K;
+
+    double scaleX = (double)frameSize.width / intrinsics.imageSize.width;
+    double scaleY = (double)frameSize.height / intrinsics.imageSize.height;
+    K.at<double>(0, 0) *= scaleX;  // fx
+    K.at<double>(1, 1) *= scaleY;  // fy
+    K.at<double>(0, 2) *= scaleX;  // cx
+    K.at<double>(1, 2) *= scaleY;  // cy
+    return K;
+}
+
+string cameraIdFromArgs(int argc, char **argv, const string &fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--camera-id") return argv[i + 1];
+    }
+    return fallback;
+}
@@ -0,0 +1,93 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Intrinsics Store (shared camera parameter loader)
+ ---------------------------------------------------------
+ * One binary file holds the intrinsics of many cameras, keyed by camera id
+ * (serial or "camera_<n>") and resolution. The file is memory-mapped and
+ * looked up through an open-addressing hash table, so finding one camera
+ * among hundreds costs a hash and a probe instead of parsing YAML.
+ *
+ * YAML files in the calibrate_camera / camera_comparison format remain the
+ * human-readable import/export path, and the fallback for the default camera
+ * (or the camera named in the file's camera_id) when the store has no entry.
+ */
+
+#ifndef INTRINSICS_STORE_H
+#define INTRINSICS_STORE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char *const DEFAULT_INTRINSICS_STORE = "camera_intrinsics.store";
+const char *const DEFAULT_INTRINSICS_YAML = "camera_intrinsics.yml";
+const char *const DEFAULT_CAMERA_ID = "camera_0";
+
+struct CameraIntrinsics {
+    std::string cameraId;
+    cv::Size imageSize;          // Calibration resolution, empty if unknown
+    cv::Mat cameraMatrix;        // 3x3 CV_64F
+    cv::Mat distCoeffs;          // Nx1 CV_64F
+    double reprojectionError = 0.0;
+};
+
+// Read-only, memory-mapped view of a store file
+class IntrinsicsStore {
+public:
+    IntrinsicsStore() = default;
+    ~IntrinsicsStore();
+    IntrinsicsStore(const IntrinsicsStore &) = delete;
+    IntrinsicsStore &operator=(const IntrinsicsStore &) = delete;
+
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    // Exact id + resolution; an empty size returns the id's first entry
+    bool find(const std::string &cameraId, cv::Size imageSize, CameraIntrinsics &out) const;
+
+    size_t size() const;
+    CameraIntrinsics entry(size_t index) const;
+
+    // Write a complete store (replaces the file)
+    static bool write(const std::string &filename, const std::vector<CameraIntrinsics> &entries);
+
+private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<uint8_t> buffer_;  // Read fallback where mmap is unavailable
+};
+
+// Add or replace one entry in a store file, creating it if needed
+bool upsertIntrinsics(const std::string &storeFile, const CameraIntrinsics &intrinsics);
+
+// YAML import/export (camera_matrix, distortion_coefficients, image_width/height)
+bool readIntrinsicsYaml(const std::string &filename, CameraIntrinsics &intrinsics);
+bool writeIntrinsicsYaml(const std::string &filename, const CameraIntrinsics &intrinsics);
+
+// Shared loader for all tools: the store first, then the YAML file. Given the
+// frame size, the exact resolution is preferred; otherwise the id's closest
+// calibration is returned, to be rescaled with scaledCameraMatrix. The YAML
+// file is only used for DEFAULT_CAMERA_ID or the id it names, so an unknown
+// id fails instead of silently taking another camera's calibration.
+bool loadCameraIntrinsics(const std::string &cameraId, cv::Size imageSize, CameraIntrinsics &intrinsics,
+                          const std::string &storeFile = DEFAULT_INTRINSICS_STORE,
+                          const std::string &yamlFile = DEFAULT_INTRINSICS_YAML);
+
+// Same, on a store the caller keeps open for many lookups (it may be closed,
+// leaving only the YAML fallback)
+bool loadCameraIntrinsics(const IntrinsicsStore &store, const std::string &cameraId, cv::Size imageSize,
+                          CameraIntrinsics &intrinsics, const std::string &yamlFile = DEFAULT_INTRINSICS_YAML);
+
+// Camera matrix for frames of frameSize. fx/cx and fy/cy scale with the
+// ratio to the calibration resolution; unchanged if that resolution is unknown.
+cv::Mat scaledCameraMatrix(const CameraIntrinsics &intrinsics, cv::Size frameSize);
+
+// Value of "--camera-id <id>" in argv, or fallback
+std::string cameraIdFromArgs(int argc, char **argv, const std::string &fallback = DEFAULT_CAMERA_ID);
+
+#endif // INTRINSICS_STORE_H
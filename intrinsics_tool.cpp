@@ -0,0 +1,115 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Intrinsics Store Tool (Extension)
+ ---------------------------------------------------------
+ * Human-facing import/export for the binary intrinsics store.
+ *
+ * Usage: intrinsics_tool list   [store]
+ *        intrinsics_tool import <camera_id> <intrinsics.yml> [store]
+ *        intrinsics_tool export <camera_id> <WxH|any> <intrinsics.yml> [store]
+ *
+ * The store defaults to camera_intrinsics.store in the working directory.
+ */
+
+#include <opencv2/opencv.hpp>
+#include "intrinsics_store.h"
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace cv;
+using namespace std;
+
+void printUsage(const char *program) {
+    cerr << "Usage: " << program << " list [store]" << endl;
+    cerr << "       " << program << " import <camera_id> <intrinsics.yml> [store]" << endl;
+    cerr << "       " << program << " export <camera_id> <WxH|any> <intrinsics.yml> [store]" << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    string command = argv[1];
+
+    if (command == "list") {
+        string storeFile = (argc > 2) ? argv[2] : DEFAULT_INTRINSICS_STORE;
+        IntrinsicsStore store;
+        if (!store.open(storeFile)) {
+            cerr << "Failed to open store: " << storeFile << endl;
+            return -1;
+        }
+        cout << left << setw(24) << "Camera"
+             << setw(14) << "Resolution"
+             << setw(12) << "fx"
+             << setw(12) << "fy"
+             << setw(12) << "Error (px)" << endl;
+        cout << string(74, '-') << endl;
+        for (size_t i = 0; i < store.size(); i++) {
+            CameraIntrinsics e = store.entry(i);
+            cout << left << setw(24) << e.cameraId
+                 << setw(14) << (to_string(e.imageSize.width) + "x" + to_string(e.imageSize.height))
+                 << setw(12) << fixed << setprecision(2) << e.cameraMatrix.at<double>(0, 0)
+                 << setw(12) << e.cameraMatrix.at<double>(1, 1)
+                 << setw(12) << setprecision(4) << e.reprojectionError << endl;
+        }
+        cout << store.size() << " entries" << endl;
+        return 0;
+    }
+
+    if (command == "import" && argc >= 4) {
+        string storeFile = (argc > 4) ? argv[4] : DEFAULT_INTRINSICS_STORE;
+        CameraIntrinsics intrinsics;
+        if (!readIntrinsicsYaml(argv[3], intrinsics)) {
+            cerr << "Failed to read camera parameters file: " << argv[3] << endl;
+            return -1;
+        }
+        intrinsics.cameraId = argv[2];
+        if (!upsertIntrinsics(storeFile, intrinsics)) {
+            cerr << "Failed to update store: " << storeFile << endl;
+            return -1;
+        }
+        cout << "✓ Imported " << intrinsics.cameraId << " ("
+             << intrinsics.imageSize.width << "x" << intrinsics.imageSize.height
+             << ") into " << storeFile << endl;
+        return 0;
+    }
+
+    if (command == "export" && argc >= 5) {
+        string storeFile = (argc > 5) ? argv[5] : DEFAULT_INTRINSICS_STORE;
+        Size imageSize;
+        string sizeArg = argv[3];
+        if (sizeArg != "any") {
+            // Whole argument must be WxH with positive sizes
+            int width = 0, height = 0, used = 0;
+            if (sscanf(sizeArg.c_str(), "%dx%d%n", &width, &height, &used) != 2 ||
+                used != (int)sizeArg.size() || width <= 0 || height <= 0) {
+                cerr << "Invalid resolution: " << sizeArg << endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            imageSize = Size(width, height);
+        }
+
+        IntrinsicsStore store;
+        CameraIntrinsics intrinsics;
+        if (!store.open(storeFile) || !store.find(argv[2], imageSize, intrinsics)) {
+            cerr << "No entry for " << argv[2] << " (" << sizeArg << ") in " << storeFile << endl;
+            return -1;
+        }
+        if (!writeIntrinsicsYaml(argv[4], intrinsics)) {
+            cerr << "Failed to write " << argv[4] << endl;
+            return -1;
+        }
+        cout << "✓ Exported " << intrinsics.cameraId << " to " << argv[4] << endl;
+        return 0;
+    }
+
+    printUsage(argv[0]);
+    return -1;
+}
@@ -0,0 +1,788 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Kernel Benchmark (performance regression harness)
+ ---------------------------------------------------------
+ * Times the hot kernels of the tools on synthetic input (or a recorded
+ * frame), at several sizes each, so performance changes can be measured
+ * without a camera:
+ *   board_detect     findChessboardCorners on a rendered board     (image size)
+ *   board_detect_sb  findChessboardCornersSB on the same board      (image size)
+ *   board_empty      findChessboardCorners on a frame without a board (image size)
+ *   board_presence   boardLikelyPresent incl. pyrDown, on that frame  (image size)
+ *   subpix           cornerSubPix on the detected corners           (image size)
+ *   subpix_batch     refineBoardCorners, gradient method, same start (image size)
+ *   subpix_saddle    refineBoardCorners, saddle method, same start   (image size)
+ *   harris_nms       detectHarrisCorners as used by feature_detection (image size)
+ *   orb_extract      ORB detectAndCompute on a textured image       (image size)
+ *   calibrate        calibrateCamera on synthetic board views       (view count)
+ *   solvepnp         solvePnP for a planar grid                     (grid size)
+ *   project          projectPoints with distortion                  (point count)
+ *   knn_match        Hamming knnMatch + ratio test                  (feature count)
+ *   find_homography  findHomographyRobust (PROSAC) as feature_detection calls it,
+ *                    best-first matches with 30% outliers           (match count)
+ *
+ * Each kernel runs a few warm-up iterations, then up to --repeats timed runs
+ * (fewer for slow kernels, see TIME_BUDGET_MS); median and minimum are kept.
+ *
+ * Results are JSON (cv::FileStorage) tagged with the machine and git commit.
+ * When a baseline for this machine exists (benchmarks/baseline_<host>.json)
+ * every median is compared against it and the run fails when one regresses
+ * by more than --tolerance. Without a baseline nothing is compared and a
+ * warning is printed; --require-baseline (used by the bench-check target)
+ * makes that a failure. --compare prints saved runs side by side, e.g. the
+ * results of several commits.
+ *
+ * --presence-check measures the board presence check instead of timing: its
+ * false-negative rate on rendered boards that findChessboardCorners finds
+ * (varied in scale, tilt, rotation, blur, noise and contrast), and how many
+ * board-free frames it rejects.
+ *
+ * --subpix-check compares corner refinement against the true corners of
+ * rendered boards (varied in size, tilt, blur and noise), starting each
+ * method from the same perturbed corners: RMS and worst error, and time per
+ * board, for cornerSubPix and both refineBoardCorners methods.
+ *
+ * Usage: kernel_benchmark [--repeats N] [--filter substr] [--input frame.png]
+ *                         [--out run.json] [--baseline file] [--save-baseline]
+ *                         [--tolerance 0.15] [--require-baseline]
+ *        kernel_benchmark --compare run_a.json run_b.json [...]
+ *        kernel_benchmark --presence-check
+ *        kernel_benchmark --subpix-check
+ */
+
+#include <opencv2/opencv.hpp>
+#include "board_detection.h"
+#include "board_detector.h"
+#include "board_subpix.h"
+#include "harris_corners.h"
+#include "homography_estimation.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+const int WARMUP_RUNS = 2;
+const int MIN_RUNS = 5;
+const double TIME_BUDGET_MS = 2000.0;  // Per kernel, once MIN_RUNS are done
+const char *const BASELINE_DIR = "benchmarks";
+
+struct BenchResult {
+    string kernel;
+    string size;
+    double medianMs = 0.0;
+    double minMs = 0.0;
+    int runs = 0;
+};
+
+struct BenchRun {
+    string machine;
+    string commit;
+    vector<BenchResult> results;
+};
+
+struct Kernel {
+    string name;
+    string size;
+    function<void()> run;
+};
+
+string machineName() {
+    char host[256] = "unknown";
+#ifndef _WIN32
+    if (gethostname(host, sizeof(host)) != 0) strcpy(host, "unknown");
+    host[sizeof(host) - 1] = '\0';
+#endif
+    return host;
+}
+
+string currentCommit() {
+    string commit = "unknown";
+#ifndef _WIN32
+    FILE *pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r");
+    if (pipe) {
+        char buf[64] = {0};
+        if (fgets(buf, sizeof(buf), pipe)) {
+            commit = buf;
+            commit.erase(commit.find_last_not_of(" \n\r") + 1);
+        }
+        pclose(pipe);
+    }
+#endif
+    return commit.empty() ? "unknown" : commit;
+}
+
+BenchResult timeKernel(const Kernel &kernel, int repeats) {
+    for (int i = 0; i < WARMUP_RUNS; i++) kernel.run();
+    vector<double> times;
+    double total = 0;
+    while ((int)times.size() < repeats && ((int)times.size() < MIN_RUNS || total < TIME_BUDGET_MS)) {
+        int64 start = getTickCount();
+        kernel.run();
+        double ms = (getTickCount() - start) * 1000.0 / getTickFrequency();
+        times.push_back(ms);
+        total += ms;
+    }
+    sort(times.begin(), times.end());
+
+    BenchResult r;
+    r.kernel = kernel.name;
+    r.size = kernel.size;
+    r.medianMs = times[times.size() / 2];
+    r.minMs = times[0];
+    r.runs = (int)times.size();
+    return r;
+}
+
+bool writeRun(const string &filename, const BenchRun &run) {
+    FileStorage fs(filename, FileStorage::WRITE | FileStorage::FORMAT_JSON);
+    if (!fs.isOpened()) return false;
+    fs << "machine" << run.machine;
+    fs << "commit" << run.commit;
+    fs << "results" << "[";
+    for (const auto &r : run.results) {
+        fs << "{" << "kernel" << r.kernel << "size" << r.size
+           << "median_ms" << r.medianMs << "min_ms" << r.minMs << "runs" << r.runs << "}";
+    }
+    fs << "]";
+    return true;
+}
+
+bool readRun(const string &filename, BenchRun &run) {
+    FileStorage fs;
+    try {
+        if (!fs.open(filename, FileStorage::READ)) return false;
+    } catch (const cv::Exception &) {
+        return false;
+    }
+    fs["machine"] >> run.machine;
+    fs["commit"] >> run.commit;
+    run.results.clear();
+    for (const auto &node : fs["results"]) {
+        BenchResult r;
+        node["kernel"] >> r.kernel;
+        node["size"] >> r.size;
+        node["median_ms"] >> r.medianMs;
+        node["min_ms"] >> r.minMs;
+        node["runs"] >> r.runs;
+        run.results.push_back(r);
+    }
+    return true;
+}
+
+string resultKey(const BenchResult &r) {
+    return r.kernel + "@" + r.size;
+}
+
+// Blurred noise: plenty of corners for ORB and Harris at every scale
+Mat texturedImage(Size size, uint64 seed) {
+    Mat image(size, CV_8UC1);
+    RNG rng(seed);
+    rng.fill(image, RNG::UNIFORM, 0, 256);
+    GaussianBlur(image, image, Size(0, 0), 2.0);
+    normalize(image, image, 0, 255, NORM_MINMAX);
+    return image;
+}
+
+Mat pinholeCamera(Size size) {
+    return (Mat_<double>(3, 3) << size.width, 0, size.width / 2.0,
+                                  0, size.width, size.height / 2.0,
+                                  0, 0, 1);
+}
+
+string sizeLabel(Size s) {
+    return to_string(s.width) + "x" + to_string(s.height);
+}
+
+// Inputs for every kernel, built once before timing
+struct BenchInputs {
+    struct ImageCase {
+        string label;
+        Mat board;                  // Board image, for detection / subpix
+        vector<Point2f> corners;    // Detected corners, subpix start
+        Mat scene;                  // Textured image, for Harris / ORB / empty frames
+        FramePyramid pyramid;       // Rebuilt per run by board_presence
+    };
+    vector<ImageCase> images;
+
+    struct CalibCase {
+        string label;
+        vector<vector<Point3f>> objectPoints;
+        vector<vector<Point2f>> imagePoints;
+    };
+    vector<CalibCase> calibrations;
+
+    struct PnpCase {
+        string label;
+        vector<Point3f> objectPoints;
+        vector<Point2f> imagePoints;
+    };
+    vector<PnpCase> pnp;
+
+    struct ProjectCase {
+        string label;
+        vector<Point3f> points;
+    };
+    vector<ProjectCase> projections;
+
+    struct MatchCase {
+        string label;
+        Mat descA, descB;
+    };
+    vector<MatchCase> matches;
+
+    struct HomographyCase {
+        string label;
+        vector<Point2f> src, dst;
+    };
+    vector<HomographyCase> homographies;
+
+    Mat cameraMatrix = pinholeCamera(Size(1280, 720));
+    Mat distCoeffs = (Mat_<double>(5, 1) << 0.1, -0.2, 0, 0, 0.05);
+    Mat rvec = (Mat_<double>(3, 1) << 0.3, -0.2, 0.05);
+    Mat tvec = (Mat_<double>(3, 1) << -4.0, -2.5, 15.0);
+};
+
+void addImageCase(BenchInputs &in, const string &label, const Mat &board, const Mat &scene) {
+    BenchInputs::ImageCase c;
+    c.label = label;
+    c.board = board;
+    c.scene = scene;
+    if (!board.empty()) findChessboardCorners(board, BOARD_PATTERN_SIZE, c.corners, LIVE_BOARD_FLAGS);
+    in.images.push_back(c);
+}
+
+BenchInputs buildInputs(const string &recordedFrame) {
+    BenchInputs in;
+    RNG rng(12345);
+
+    for (Size s : {Size(640, 480), Size(1280, 720), Size(1920, 1080)}) {
+        addImageCase(in, sizeLabel(s), renderSyntheticBoard(BOARD_PATTERN_SIZE, s, 0.3), texturedImage(s, 42));
+    }
+    if (!recordedFrame.empty()) {
+        Mat frame = imread(recordedFrame, IMREAD_GRAYSCALE);
+        if (frame.empty()) {
+            cerr << "Warning: could not read " << recordedFrame << endl;
+        } else {
+            // The recorded frame serves as both board and scene input
+            addImageCase(in, "recorded_" + sizeLabel(frame.size()), frame, frame);
+        }
+    }
+
+    // Views of the board from random poses around the default one
+    vector<Point3f> board = boardObjectPoints(BOARD_PATTERN_SIZE, 1.0f);
+    Mat K = pinholeCamera(Size(640, 480));
+    for (int views : {5, 10, 20}) {
+        BenchInputs::CalibCase c;
+        c.label = to_string(views) + "_views";
+        for (int v = 0; v < views; v++) {
+            Mat rvec = (Mat_<double>(3, 1) << rng.uniform(-0.5, 0.5), rng.uniform(-0.5, 0.5), rng.uniform(-0.2, 0.2));
+            Mat tvec = (Mat_<double>(3, 1) << rng.uniform(-6.0, -3.0), rng.uniform(-4.0, -2.0), rng.uniform(12.0, 20.0));
+            vector<Point2f> projected;
+            projectPoints(board, rvec, tvec, K, in.distCoeffs, projected);
+            for (auto &p : projected) p += Point2f((float)rng.gaussian(0.1), (float)rng.gaussian(0.1));
+            c.objectPoints.push_back(board);
+            c.imagePoints.push_back(projected);
+        }
+        in.calibrations.push_back(c);
+    }
+
+    for (Size grid : {Size(5, 4), BOARD_PATTERN_SIZE, Size(16, 12)}) {
+        BenchInputs::PnpCase c;
+        c.label = sizeLabel(grid);
+        c.objectPoints = boardObjectPoints(grid, 8.0f / grid.width);
+        projectPoints(c.objectPoints, in.rvec, in.tvec, in.cameraMatrix, in.distCoeffs, c.imagePoints);
+        in.pnp.push_back(c);
+    }
+
+    for (int n : {1000, 10000, 100000}) {
+        BenchInputs::ProjectCase c;
+        c.label = to_string(n) + "_points";
+        c.points.resize(n);
+        for (auto &p : c.points) p = Point3f(rng.uniform(0.f, 8.f), rng.uniform(0.f, 5.f), rng.uniform(-5.f, 0.f));
+        in.projections.push_back(c);
+    }
+
+    // Two views of one textured scene
+    Mat scene = texturedImage(Size(1280, 720), 7);
+    Mat rotation = getRotationMatrix2D(Point2f(640, 360), 10, 0.9);
+    Mat sceneView;
+    warpAffine(scene, sceneView, rotation, scene.size());
+    for (int n : {500, 1000, 2000}) {
+        BenchInputs::MatchCase c;
+        c.label = to_string(n) + "_features";
+        Ptr<ORB> orb = ORB::create(n);
+        vector<KeyPoint> kpA, kpB;
+        orb->detectAndCompute(scene, noArray(), kpA, c.descA);
+        orb->detectAndCompute(sceneView, noArray(), kpB, c.descB);
+        in.matches.push_back(c);
+    }
+
+    Matx33d H(0.9, 0.1, 20, -0.08, 0.95, 10, 1e-4, 5e-5, 1);
+    for (int n : {100, 500, 2000}) {
+        BenchInputs::HomographyCase c;
+        c.label = to_string(n) + "_matches";
+        for (int i = 0; i < n; i++) {
+            Point2f p(rng.uniform(0.f, 1280.f), rng.uniform(0.f, 720.f));
+            Point2f q;
+            // Ordered like distance-sorted matches: outliers grow more likely
+            // towards the end, 30% overall
+            if (rng.uniform(0.0, 1.0) < 0.6 * i / n) {
+                q = Point2f(rng.uniform(0.f, 1280.f), rng.uniform(0.f, 720.f));  // Outlier
+            } else {
+                Vec3d h = H * Vec3d(p.x, p.y, 1);
+                q = Point2f((float)(h[0] / h[2] + rng.gaussian(0.5)), (float)(h[1] / h[2] + rng.gaussian(0.5)));
+            }
+            c.src.push_back(p);
+            c.dst.push_back(q);
+        }
+        in.homographies.push_back(c);
+    }
+    return in;
+}
+
+vector<Kernel> buildKernels(BenchInputs &in) {
+    vector<Kernel> kernels;
+    for (auto &c : in.images) {
+        BenchInputs::ImageCase *ic = &c;
+        kernels.push_back({"board_detect", c.label, [ic]() {
+            vector<Point2f> corners;
+            findChessboardCorners(ic->board, BOARD_PATTERN_SIZE, corners, LIVE_BOARD_FLAGS);
+        }});
+        kernels.push_back({"board_detect_sb", c.label, [ic]() {
+            vector<Point2f> corners;
+            findChessboardCornersSB(ic->board, BOARD_PATTERN_SIZE, corners, SB_BOARD_FLAGS);
+        }});
+        kernels.push_back({"board_empty", c.label, [ic]() {
+            vector<Point2f> corners;
+            findChessboardCorners(ic->scene, BOARD_PATTERN_SIZE, corners, LIVE_BOARD_FLAGS);
+        }});
+        kernels.push_back({"board_presence", c.label, [ic]() {
+            ic->pyramid.reset(ic->scene);
+            boardLikelyPresent(ic->pyramid, BOARD_PATTERN_SIZE);
+        }});
+        if (!c.corners.empty()) {
+            kernels.push_back({"subpix", c.label, [ic]() {
+                vector<Point2f> corners = ic->corners;
+                cornerSubPix(ic->board, corners, BOARD_SUBPIX_WINDOW, Size(-1, -1), BOARD_SUBPIX_CRITERIA);
+            }});
+            kernels.push_back({"subpix_batch", c.label, [ic]() {
+                vector<Point2f> corners = ic->corners;
+                refineBoardCorners(ic->board, corners, BOARD_SUBPIX_WINDOW, BOARD_SUBPIX_CRITERIA);
+            }});
+            kernels.push_back({"subpix_saddle", c.label, [ic]() {
+                vector<Point2f> corners = ic->corners;
+                refineBoardCorners(ic->board, corners, BOARD_SUBPIX_WINDOW, BOARD_SUBPIX_CRITERIA,
+                                   SubpixMethod::Saddle);
+            }});
+        }
+        kernels.push_back({"harris_nms", c.label, [ic]() {
+            vector<Point2f> corners;
+            detectHarrisCorners(ic->scene, corners, 0.01);
+        }});
+        kernels.push_back({"orb_extract", c.label, [ic]() {
+            static Ptr<ORB> orb = ORB::create(1000);
+            vector<KeyPoint> keypoints;
+            Mat descriptors;
+            orb->detectAndCompute(ic->scene, noArray(), keypoints, descriptors);
+        }});
+    }
+    for (auto &c : in.calibrations) {
+        const BenchInputs::CalibCase *cc = &c;
+        kernels.push_back({"calibrate", c.label, [cc]() {
+            Mat K, dist;
+            vector<Mat> rvecs, tvecs;
+            calibrateCamera(cc->objectPoints, cc->imagePoints, Size(640, 480), K, dist, rvecs, tvecs);
+        }});
+    }
+    for (auto &c : in.pnp) {
+        const BenchInputs::PnpCase *pc = &c;
+        kernels.push_back({"solvepnp", c.label, [pc, &in]() {
+            Mat rvec, tvec;
+            solvePnP(pc->objectPoints, pc->imagePoints, in.cameraMatrix, in.distCoeffs, rvec, tvec);
+        }});
+    }
+    for (auto &c : in.projections) {
+        const BenchInputs::ProjectCase *pc = &c;
+        kernels.push_back({"project", c.label, [pc, &in]() {
+            vector<Point2f> projected;
+            projectPoints(pc->points, in.rvec, in.tvec, in.cameraMatrix, in.distCoeffs, projected);
+        }});
+    }
+    for (auto &c : in.matches) {
+        const BenchInputs::MatchCase *mc = &c;
+        kernels.push_back({"knn_match", c.label, [mc]() {
+            BFMatcher matcher(NORM_HAMMING);
+            vector<vector<DMatch>> knn;
+            matcher.knnMatch(mc->descA, mc->descB, knn, 2);
+            int good = 0;
+            for (const auto &m : knn) {
+                if (m.size() == 2 && m[0].distance < 0.75f * m[1].distance) good++;
+            }
+            (void)good;
+        }});
+    }
+    for (auto &c : in.homographies) {
+        const BenchInputs::HomographyCase *hc = &c;
+        kernels.push_back({"find_homography", c.label, [hc]() {
+            Mat mask;
+            findHomographyRobust(hc->src, hc->dst, mask);
+        }});
+    }
+    return kernels;
+}
+
+// Gaussian noise with the given sigma, saturated to 8 bits
+void addNoise(Mat &frame, double sigma, RNG &rng) {
+    if (sigma <= 0) return;
+    Mat noisy, n(frame.size(), CV_16S);
+    rng.fill(n, RNG::NORMAL, 0, sigma);
+    frame.convertTo(noisy, CV_16S);
+    noisy += n;
+    noisy.convertTo(frame, CV_8U);
+}
+
+// Frame with a board covering `scale` of it, rotated, blurred, dimmed to the
+// given contrast around mid-gray and noised
+Mat presenceTestFrame(Size frameSize, double scale, double tilt, double angle, double blur,
+                      double contrast, double noise, RNG &rng) {
+    Size boardSize(cvRound(frameSize.width * scale), cvRound(frameSize.height * scale));
+    Mat frame(frameSize, CV_8UC1, Scalar(255));
+    renderSyntheticBoard(BOARD_PATTERN_SIZE, boardSize, tilt)
+        .copyTo(frame(Rect((frameSize.width - boardSize.width) / 2,
+                           (frameSize.height - boardSize.height) / 2, boardSize.width, boardSize.height)));
+
+    Mat rotation = getRotationMatrix2D(Point2f(frameSize.width / 2.f, frameSize.height / 2.f), angle, 1.0);
+    warpAffine(frame, frame, rotation, frameSize, INTER_LINEAR, BORDER_CONSTANT, Scalar(255));
+    if (blur > 0) GaussianBlur(frame, frame, Size(0, 0), blur);
+    frame.convertTo(frame, CV_8U, contrast / 255.0, 128 - contrast / 2);
+
+    addNoise(frame, noise, rng);
+    return frame;
+}
+
+// False negatives of boardLikelyPresent on boards the detector finds, and
+// rejections of board-free frames
+int runPresenceCheck() {
+    RNG rng(2024);
+    int boards = 0, missed = 0, undetected = 0;
+    cout << "Rendering test boards..." << endl;
+    for (Size frameSize : {Size(640, 480), Size(1280, 720), Size(1920, 1080)}) {
+        for (double scale : {0.25, 0.4, 0.6, 1.0}) {
+            for (double tilt : {0.0, 0.3, 0.6}) {
+                for (double angle : {0.0, 20.0, 45.0}) {
+                    for (double blur : {0.0, 1.5}) {
+                        for (double contrast : {60.0, 200.0}) {
+                            for (double noise : {0.0, 6.0}) {
+                                Mat frame = presenceTestFrame(frameSize, scale, tilt, angle, blur,
+                                                              contrast, noise, rng);
+                                FramePyramid pyramid;
+                                pyramid.reset(frame);
+                                int lvl = pyramid.levelForWidth(DEFAULT_DETECTION_WIDTH);
+
+                                // Only boards the detector itself finds count
+                                vector<Point2f> corners;
+                                if (!findChessboardCorners(pyramid.level(lvl), BOARD_PATTERN_SIZE,
+                                                           corners, LIVE_BOARD_FLAGS)) {
+                                    undetected++;
+                                    continue;
+                                }
+                                boards++;
+                                if (!boardLikelyPresent(pyramid, BOARD_PATTERN_SIZE)) {
+                                    missed++;
+                                    cout << "  missed: " << sizeLabel(frameSize) << " scale " << scale
+                                         << " tilt " << tilt << " angle " << angle << " blur " << blur
+                                         << " contrast " << contrast << " noise " << noise << endl;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Board-free frames: blurred noise at several grain sizes, and flat
+    // rectangles (edges and L-corners, no X-junctions)
+    int empty = 0, rejected = 0;
+    double checkMs = 0;
+    for (Size frameSize : {Size(640, 480), Size(1280, 720), Size(1920, 1080)}) {
+        for (int seed = 0; seed < 10; seed++) {
+            Mat frame = texturedImage(frameSize, seed);
+            if (seed % 2 == 1) {
+                frame.setTo(Scalar(128));
+                for (int r = 0; r < 40; r++) {
+                    Rect box(rng.uniform(0, frameSize.width), rng.uniform(0, frameSize.height),
+                             rng.uniform(10, frameSize.width / 4), rng.uniform(10, frameSize.height / 4));
+                    rectangle(frame, box, Scalar(rng.uniform(0, 256)), FILLED);
+                }
+            } else if (seed > 0) {
+                GaussianBlur(frame, frame, Size(0, 0), seed);
+            }
+            FramePyramid pyramid;
+            pyramid.reset(frame);
+            int64 start = getTickCount();
+            bool present = boardLikelyPresent(pyramid, BOARD_PATTERN_SIZE);
+            checkMs += (getTickCount() - start) * 1000.0 / getTickFrequency();
+            empty++;
+            if (!present) rejected++;
+        }
+    }
+
+    cout << "\n" << string(72, '=') << endl;
+    cout << "BOARD PRESENCE CHECK" << endl;
+    cout << string(72, '=') << endl;
+    cout << fixed << setprecision(1);
+    cout << "Boards found by findChessboardCorners: " << boards << " (" << undetected
+         << " rendered boards it missed are not counted)" << endl;
+    cout << "False negatives: " << missed << " (" << (boards ? 100.0 * missed / boards : 0.0) << "%)" << endl;
+    cout << "Board-free frames rejected: " << rejected << " of " << empty << " ("
+         << 100.0 * rejected / empty << "%), " << setprecision(3) << checkMs / empty
+         << " ms per check incl. pyrDown" << endl;
+    return 0;
+}
+
+// Refinement error against the rendered corners, all methods starting from
+// the same corners: the truth moved up to SUBPIX_CHECK_START_PX
+const double SUBPIX_CHECK_START_PX = 1.5;
+
+int runSubpixCheck() {
+    struct Method {
+        string name;
+        function<void(const Mat &, vector<Point2f> &)> refine;
+        double sumSq = 0, worst = 0, ms = 0;
+    };
+    vector<Method> methods = {
+        {"cornerSubPix", [](const Mat &gray, vector<Point2f> &corners) {
+             cornerSubPix(gray, corners, BOARD_SUBPIX_WINDOW, Size(-1, -1), BOARD_SUBPIX_CRITERIA);
+         }},
+        {"gradient", [](const Mat &gray, vector<Point2f> &corners) {
+             refineBoardCorners(gray, corners, BOARD_SUBPIX_WINDOW, BOARD_SUBPIX_CRITERIA);
+         }},
+        {"saddle", [](const Mat &gray, vector<Point2f> &corners) {
+             refineBoardCorners(gray, corners, BOARD_SUBPIX_WINDOW, BOARD_SUBPIX_CRITERIA, SubpixMethod::Saddle);
+         }},
+    };
+
+    RNG rng(2025);
+    int boards = 0, points = 0;
+    cout << "Rendering test boards..." << endl;
+    for (Size frameSize : {Size(640, 480), Size(1280, 720), Size(1920, 1080)}) {
+        for (double tilt : {0.0, 0.3, 0.6}) {
+            for (double blur : {0.0, 1.0, 2.0}) {
+                for (double noise : {0.0, 4.0}) {
+                    vector<Point2f> truth;
+                    Mat frame = renderSyntheticBoard(BOARD_PATTERN_SIZE, frameSize, tilt, &truth);
+                    if (blur > 0) GaussianBlur(frame, frame, Size(0, 0), blur);
+                    addNoise(frame, noise, rng);
+
+                    vector<Point2f> start = truth;
+                    for (auto &p : start) {
+                        p += Point2f(rng.uniform(-1.f, 1.f), rng.uniform(-1.f, 1.f)) * SUBPIX_CHECK_START_PX;
+                    }
+
+                    for (auto &m : methods) {
+                        vector<Point2f> corners = start;
+                        int64 t0 = getTickCount();
+                        m.refine(frame, corners);
+                        m.ms += (getTickCount() - t0) * 1000.0 / getTickFrequency();
+                        for (size_t i = 0; i < corners.size(); i++) {
+                            double e = norm(corners[i] - truth[i]);
+                            m.sumSq += e * e;
+                            m.worst = max(m.worst, e);
+                        }
+                    }
+                    boards++;
+                    points += (int)truth.size();
+                }
+            }
+        }
+    }
+
+    cout << "\n" << string(72, '=') << endl;
+    cout << "SUBPIXEL REFINEMENT CHECK (" << boards << " boards, " << points << " corners)" << endl;
+    cout << string(72, '=') << endl;
+    cout << left << setw(16) << "Method" << setw(14) << "RMS (px)" << setw(14) << "Worst (px)" << "ms/board" << endl;
+    cout << string(52, '-') << endl;
+    for (const auto &m : methods) {
+        cout << left << setw(16) << m.name << fixed << setprecision(4) << setw(14) << sqrt(m.sumSq / points)
+             << setw(14) << m.worst << setprecision(3) << m.ms / boards << endl;
+    }
+    return 0;
+}
+
+// Medians of several runs side by side, one column per run
+void printComparison(const vector<BenchRun> &runs) {
+    vector<string> keys;
+    map<string, vector<double>> medians;
+    for (size_t r = 0; r < runs.size(); r++) {
+        for (const auto &res : runs[r].results) {
+            string key = resultKey(res);
+            if (!medians.count(key)) {
+                keys.push_back(key);
+                medians[key].assign(runs.size(), -1.0);
+            }
+            medians[key][r] = res.medianMs;
+        }
+    }
+
+    cout << left << setw(36) << "Kernel";
+    for (const auto &run : runs) cout << setw(14) << run.commit.substr(0, 12);
+    if (runs.size() > 1) cout << "Change";
+    cout << endl << string(36 + 14 * runs.size() + 8, '-') << endl;
+    for (const auto &key : keys) {
+        const vector<double> &m = medians[key];
+        cout << left << setw(36) << key << fixed << setprecision(3);
+        for (double v : m) {
+            if (v < 0) cout << setw(14) << "-";
+            else cout << setw(14) << v;
+        }
+        if (runs.size() > 1 && m.front() > 0 && m.back() > 0) {
+            cout << showpos << setprecision(1) << (m.back() / m.front() - 1.0) * 100.0 << "%" << noshowpos;
+        }
+        cout << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    int repeats = 30;
+    double tolerance = 0.15;
+    bool saveBaseline = false, requireBaseline = false;
+    string filter, recordedFrame, outFile, baselineFile;
+    vector<string> compareFiles;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--repeats" && i + 1 < argc) {
+            repeats = max(1, atoi(argv[++i]));
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--input" && i + 1 < argc) {
+            recordedFrame = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outFile = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baselineFile = argv[++i];
+        } else if (arg == "--save-baseline") {
+            saveBaseline = true;
+        } else if (arg == "--require-baseline") {
+            requireBaseline = true;
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (arg == "--presence-check") {
+            return runPresenceCheck();
+        } else if (arg == "--subpix-check") {
+            return runSubpixCheck();
+        } else if (arg == "--compare") {
+            while (i + 1 < argc && argv[i + 1][0] != '-') compareFiles.push_back(argv[++i]);
+        } else {
+            cerr << "Unknown argument " << arg << endl;
+            return -1;
+        }
+    }
+
+    // Side-by-side view of saved runs, no benchmarking
+    if (!compareFiles.empty()) {
+        vector<BenchRun> runs;
+        for (const auto &file : compareFiles) {
+            BenchRun run;
+            if (!readRun(file, run)) {
+                cerr << "Error: could not read " << file << endl;
+                return -1;
+            }
+            runs.push_back(run);
+        }
+        printComparison(runs);
+        return 0;
+    }
+
+    BenchRun run;
+    run.machine = machineName();
+    run.commit = currentCommit();
+    if (baselineFile.empty()) {
+        baselineFile = string(BASELINE_DIR) + "/baseline_" + run.machine + ".json";
+    }
+
+    cout << "Preparing inputs..." << endl;
+    BenchInputs inputs = buildInputs(recordedFrame);
+    vector<Kernel> kernels = buildKernels(inputs);
+
+    cout << "\n" << string(72, '=') << endl;
+    cout << "KERNEL BENCHMARK  machine " << run.machine << ", commit " << run.commit << endl;
+    cout << string(72, '=') << endl;
+    cout << left << setw(18) << "Kernel" << setw(18) << "Size" << setw(12) << "Median ms"
+         << setw(12) << "Min ms" << setw(8) << "Runs" << endl;
+    cout << string(72, '-') << endl;
+    for (const auto &kernel : kernels) {
+        if (!filter.empty() && (kernel.name + "@" + kernel.size).find(filter) == string::npos) continue;
+        BenchResult r = timeKernel(kernel, repeats);
+        run.results.push_back(r);
+        cout << left << setw(18) << r.kernel << setw(18) << r.size << fixed << setprecision(3)
+             << setw(12) << r.medianMs << setw(12) << r.minMs << setw(8) << r.runs << endl;
+    }
+    cout << string(72, '=') << endl;
+
+    if (!outFile.empty() && !writeRun(outFile, run)) {
+        cerr << "Error: could not write " << outFile << endl;
+        return -1;
+    }
+
+    if (saveBaseline) {
+        filesystem::path dir = filesystem::path(baselineFile).parent_path();
+        if (!dir.empty()) filesystem::create_directories(dir);
+        if (!writeRun(baselineFile, run)) {
+            cerr << "Error: could not write " << baselineFile << endl;
+            return -1;
+        }
+        cout << "Baseline saved to " << baselineFile << endl;
+        return 0;
+    }
+
+    BenchRun baseline;
+    if (!readRun(baselineFile, baseline)) {
+        // Nothing was checked: say so loudly, and fail where a check is required
+        cerr << "\n" << string(72, '!') << endl;
+        cerr << "WARNING: no baseline at " << baselineFile << ", nothing was compared" << endl;
+        cerr << "Create one with --save-baseline" << endl;
+        cerr << string(72, '!') << endl;
+        return requireBaseline ? 1 : 0;
+    }
+
+    // Regression check on medians
+    map<string, double> base;
+    for (const auto &r : baseline.results) base[resultKey(r)] = r.medianMs;
+    int regressions = 0;
+    cout << "\nAgainst baseline " << baselineFile << " (commit " << baseline.commit
+         << ", tolerance " << tolerance * 100 << "%)" << endl;
+    for (const auto &r : run.results) {
+        auto it = base.find(resultKey(r));
+        if (it == base.end() || it->second <= 0) continue;
+        double change = r.medianMs / it->second - 1.0;
+        if (change > tolerance) {
+            regressions++;
+            cout << "  REGRESSION " << left << setw(36) << resultKey(r) << fixed << setprecision(3)
+                 << it->second << " -> " << r.medianMs << " ms (" << showpos << setprecision(1)
+                 << change * 100 << "%" << noshowpos << ")" << endl;
+        }
+    }
+    if (regressions > 0) {
+        cout << regressions << " kernel(s) regressed" << endl;
+        return 1;
+    }
+    cout << "  No regressions" << endl;
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Luma Frame
+ ---------------------------------------------------------
+ * See luma_frame.h.
+ */
+
+#include "luma_frame.h"
+
+using namespace cv;
+using namespace std;
+
+void LumaFrame::set(const Mat &raw, PixelLayout layout) {
+    raw_ = raw;
+    layout_ = layout;
+    size_ = layout == PixelLayout::Nv12 ? Size(raw.cols, raw.rows * 2 / 3) : raw.size();
+    grayReady_ = false;
+    bgrReady_ = false;
+}
+
+void LumaFrame::release() {
+    raw_.release();
+    gray_.release();
+    bgr_.release();
+    size_ = Size();
+    grayReady_ = false;
+    bgrReady_ = false;
+}
+
+const Mat &LumaFrame::gray() {
+    if (grayReady_ || raw_.empty()) return gray_;
+    switch (layout_) {
+    case PixelLayout::Nv12:
+        gray_ = raw_.rowRange(0, size_.height);
+        break;
+    case PixelLayout::Yuyv:
+        extractChannel(raw_, grayBuf_, 0);
+        gray_ = grayBuf_;
+        break;
+    case PixelLayout::Bgr:
+        if (raw_.channels() == 1) {
+            gray_ = raw_;
+        } else {
+            cvtColor(raw_, grayBuf_, COLOR_BGR2GRAY);
+            gray_ = grayBuf_;
+        }
+        break;
+    }
+    grayReady_ = true;
+    return gray_;
+}
+
+Mat &LumaFrame::bgr() {
+    if (bgrReady_ || raw_.empty()) return bgr_;
+    switch (layout_) {
+    case PixelLayout::Nv12:
+        cvtColor(raw_, bgrBuf_, COLOR_YUV2BGR_NV12);
+        bgr_ = bgrBuf_;
+        break;
+    case PixelLayout::Yuyv:
+        cvtColor(raw_, bgrBuf_, COLOR_YUV2BGR_YUYV);
+        bgr_ = bgrBuf_;
+        break;
+    case PixelLayout::Bgr:
+        if (raw_.channels() == 1) {
+            cvtColor(raw_, bgrBuf_, COLOR_GRAY2BGR);
+            bgr_ = bgrBuf_;
+        } else {
+            bgr_ = raw_;
+        }
+        break;
+    }
+    bgrReady_ = true;
+    return bgr_;
+}
+
+size_t rawFrameBytes(Size size, PixelLayout layout) {
+    size_t pixels = (size_t)size.width * size.height;
+    switch (layout) {
+    case PixelLayout::Yuyv: return pixels * 2;
+    case PixelLayout::Nv12: return pixels * 3 / 2;
+    case PixelLayout::Bgr: return pixels * 3;
+    }
+    return 0;
+}
+
+bool wrapRawFrame(const Mat &buffer, Size size, PixelLayout layout, Mat &raw) {
+    if (buffer.empty() || !buffer.isContinuous() || size.area() == 0) return false;
+    if (buffer.depth() != CV_8U || buffer.total() * buffer.elemSize() != rawFrameBytes(size, layout)) return false;
+    // reshape shares the buffer's reference count: the view keeps it alive
+    switch (layout) {
+    case PixelLayout::Yuyv:
+        raw = buffer.reshape(2, size.height);
+        break;
+    case PixelLayout::Nv12:
+        if (size.height % 2 != 0) return false;
+        raw = buffer.reshape(1, size.height * 3 / 2);
+        break;
+    case PixelLayout::Bgr:
+        raw = buffer.reshape(3, size.height);
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Luma Frame (grayscale first, colour on demand)
+ ---------------------------------------------------------
+ * Detection only needs luma, yet every frame used to be decoded to BGR by
+ * the capture backend and then converted back to gray. A LumaFrame holds
+ * the camera's own buffer (YUYV or NV12 when capture runs with --luma) and
+ * derives the two views lazily, each at most once per frame:
+ *   gray()  NV12: a view of the Y plane, no copy
+ *           YUYV: Y extracted from the interleaved pairs (one half-size pass)
+ *           BGR:  cvtColor, as before
+ *   bgr()   converted only when something is drawn, shown or saved
+ */
+
+#ifndef LUMA_FRAME_H
+#define LUMA_FRAME_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+enum class PixelLayout : uint32_t {
+    Bgr = 0,   // CV_8UC3 (or CV_8UC1 gray)
+    Yuyv = 1,  // CV_8UC2, rows x cols, Y U Y V
+    Nv12 = 2   // CV_8UC1, rows * 3/2 x cols: Y plane then interleaved UV
+};
+
+class LumaFrame {
+public:
+    // raw is referenced, not copied (NV12: rows * 3/2 rows of bytes)
+    void set(const cv::Mat &raw, PixelLayout layout);
+    void release();
+
+    bool empty() const { return raw_.empty(); }
+    cv::Size size() const { return size_; }
+    PixelLayout layout() const { return layout_; }
+    const cv::Mat &raw() const { return raw_; }
+
+    // For BGR input bgr() is the raw frame itself: take gray() before drawing
+    const cv::Mat &gray();
+    cv::Mat &bgr();
+
+private:
+    cv::Mat raw_;
+    PixelLayout layout_ = PixelLayout::Bgr;
+    cv::Size size_;
+    cv::Mat gray_, bgr_;        // What gray() / bgr() return: views or buffers
+    cv::Mat grayBuf_, bgrBuf_;  // Conversion targets, reused between frames
+    bool grayReady_ = false, bgrReady_ = false;
+};
+
+// View a raw capture buffer (any shape, e.g. one row of bytes) as an image of
+// the given size and layout; false if the byte count does not match
+bool wrapRawFrame(const cv::Mat &buffer, cv::Size size, PixelLayout layout, cv::Mat &raw);
+
+// Bytes of one frame in the given layout
+size_t rawFrameBytes(cv::Size size, PixelLayout layout);
+
+#endif // LUMA_FRAME_H
@@ -0,0 +1,290 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Mesh
+ ---------------------------------------------------------
+ * See mesh.h.
+ */
+
+#include "mesh.h"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Exact bit pattern of a position, for deduplication
+struct PositionKey {
+    uint32_t bits[3];
+    bool operator==(const PositionKey &o) const { return memcmp(bits, o.bits, sizeof(bits)) == 0; }
+};
+
+struct PositionHash {
+    size_t operator()(const PositionKey &k) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (uint32_t b : k.bits) {
+            h ^= b;
+            h *= 1099511628211ULL;
+        }
+        return (size_t)h;
+    }
+};
+
+PositionKey keyOf(float x, float y, float z) {
+    // -0 and +0 are the same position
+    if (x == 0) x = 0;
+    if (y == 0) y = 0;
+    if (z == 0) z = 0;
+    PositionKey k;
+    memcpy(&k.bits[0], &x, 4);
+    memcpy(&k.bits[1], &y, 4);
+    memcpy(&k.bits[2], &z, 4);
+    return k;
+}
+
+// Fan-triangulate one polygon
+void addPolygon(Mesh &mesh, const vector<int> &indices, Vec3b color) {
+    for (size_t i = 2; i < indices.size(); i++) {
+        mesh.faces.push_back(Vec3i(indices[0], indices[i - 1], indices[i]));
+        mesh.faceColors.push_back(color);
+    }
+}
+
+bool loadObj(const string &filename, Mesh &mesh, Vec3b color) {
+    ifstream in(filename);
+    if (!in) return false;
+
+    string line;
+    vector<int> polygon;
+    while (getline(in, line)) {
+        if (line.size() < 2) continue;
+        if (line[0] == 'v' && line[1] == ' ') {
+            Point3f p;
+            stringstream ss(line.substr(2));
+            if (ss >> p.x >> p.y >> p.z) mesh.addVertex(p);
+        } else if (line[0] == 'f' && line[1] == ' ') {
+            // "f v", "f v/vt", "f v//vn", "f v/vt/vn"; negative = relative
+            stringstream ss(line.substr(2));
+            string token;
+            polygon.clear();
+            while (ss >> token) {
+                int index = atoi(token.c_str());
+                if (index < 0) index += (int)mesh.numVertices();
+                else index -= 1;
+                if (index < 0 || index >= (int)mesh.numVertices()) {
+                    cerr << "Error: " << filename << ": bad face index in \"" << line << "\"" << endl;
+                    return false;
+                }
+                polygon.push_back(index);
+            }
+            addPolygon(mesh, polygon, color);
+        }
+    }
+    return true;
+}
+
+struct PlyProperty {
+    string name;
+    string type;
+    bool isList = false;
+    string countType;
+};
+
+struct PlyElement {
+    string name;
+    size_t count = 0;
+    vector<PlyProperty> properties;
+};
+
+size_t plyTypeSize(const string &type) {
+    if (type == "char" || type == "uchar" || type == "int8" || type == "uint8") return 1;
+    if (type == "short" || type == "ushort" || type == "int16" || type == "uint16") return 2;
+    if (type == "int" || type == "uint" || type == "int32" || type == "uint32" ||
+        type == "float" || type == "float32") return 4;
+    if (type == "double" || type == "float64") return 8;
+    return 0;
+}
+
+// One value of the given type; binary data is little-endian
+bool readPlyValue(istream &in, bool binary, const string &type, double &value) {
+    if (!binary) return (bool)(in >> value);
+
+    unsigned char bytes[8];
+    size_t size = plyTypeSize(type);
+    if (size == 0 || !in.read((char*)bytes, size)) return false;
+    if (type == "char" || type == "int8") value = (int8_t)bytes[0];
+    else if (type == "uchar" || type == "uint8") value = bytes[0];
+    else if (type == "short" || type == "int16") { int16_t v; memcpy(&v, bytes, 2); value = v; }
+    else if (type == "ushort" || type == "uint16") { uint16_t v; memcpy(&v, bytes, 2); value = v; }
+    else if (type == "int" || type == "int32") { int32_t v; memcpy(&v, bytes, 4); value = v; }
+    else if (type == "uint" || type == "uint32") { uint32_t v; memcpy(&v, bytes, 4); value = v; }
+    else if (type == "float" || type == "float32") { float v; memcpy(&v, bytes, 4); value = v; }
+    else { double v; memcpy(&v, bytes, 8); value = v; }
+    return true;
+}
+
+bool loadPly(const string &filename, Mesh &mesh, Vec3b color) {
+    ifstream in(filename, ios::binary);
+    if (!in) return false;
+
+    string line;
+    if (!getline(in, line) || line.compare(0, 3, "ply") != 0) return false;
+
+    bool binary = false;
+    vector<PlyElement> elements;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        stringstream ss(line);
+        string keyword;
+        ss >> keyword;
+        if (keyword == "format") {
+            string format;
+            ss >> format;
+            if (format == "binary_little_endian") binary = true;
+            else if (format != "ascii") {
+                cerr << "Error: " << filename << ": unsupported PLY format " << format << endl;
+                return false;
+            }
+        } else if (keyword == "element") {
+            PlyElement e;
+            ss >> e.name >> e.count;
+            elements.push_back(e);
+        } else if (keyword == "property" && !elements.empty()) {
+            PlyProperty p;
+            ss >> p.type;
+            if (p.type == "list") {
+                p.isList = true;
+                ss >> p.countType >> p.type;
+            }
+            ss >> p.name;
+            elements.back().properties.push_back(p);
+        } else if (keyword == "end_header") {
+            break;
+        }
+    }
+
+    vector<int> polygon;
+    for (const PlyElement &e : elements) {
+        bool isVertex = e.name == "vertex";
+        bool isFace = e.name == "face";
+        for (size_t item = 0; item < e.count; item++) {
+            Point3f p;
+            for (const PlyProperty &prop : e.properties) {
+                double value;
+                if (!prop.isList) {
+                    if (!readPlyValue(in, binary, prop.type, value)) return false;
+                    if (isVertex && prop.name == "x") p.x = (float)value;
+                    else if (isVertex && prop.name == "y") p.y = (float)value;
+                    else if (isVertex && prop.name == "z") p.z = (float)value;
+                    continue;
+                }
+
+                double count;
+                if (!readPlyValue(in, binary, prop.countType, count)) return false;
+                bool indices = isFace && (prop.name == "vertex_indices" || prop.name == "vertex_index");
+                polygon.clear();
+                for (int k = 0; k < (int)count; k++) {
+                    if (!readPlyValue(in, binary, prop.type, value)) return false;
+                    if (indices) polygon.push_back((int)value);
+                }
+                if (indices) {
+                    for (int index : polygon) {
+                        if (index < 0 || index >= (int)mesh.numVertices()) {
+                            cerr << "Error: " << filename << ": bad face index " << index << endl;
+                            return false;
+                        }
+                    }
+                    addPolygon(mesh, polygon, color);
+                }
+            }
+            if (isVertex) mesh.addVertex(p);
+        }
+        if (isFace) break;  // Nothing after the faces is needed
+    }
+    return true;
+}
+
+} // namespace
+
+void weldVertices(Mesh &mesh) {
+    unordered_map<PositionKey, int, PositionHash> firstIndex;
+    firstIndex.reserve(mesh.numVertices());
+    vector<int> remap(mesh.numVertices());
+    Mesh welded;
+
+    for (size_t i = 0; i < mesh.numVertices(); i++) {
+        auto it = firstIndex.emplace(keyOf(mesh.x[i], mesh.y[i], mesh.z[i]), (int)welded.numVertices());
+        if (it.second) welded.addVertex(mesh.vertex((int)i));
+        remap[i] = it.first->second;
+    }
+
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        Vec3i face(remap[mesh.faces[f][0]], remap[mesh.faces[f][1]], remap[mesh.faces[f][2]]);
+        if (face[0] == face[1] || face[1] == face[2] || face[0] == face[2]) continue;
+        welded.faces.push_back(face);
+        welded.faceColors.push_back(mesh.faceColors[f]);
+    }
+
+    mesh = std::move(welded);
+}
+
+bool loadMesh(const string &filename, Mesh &mesh, Vec3b faceColor) {
+    string ext = filename.substr(filename.find_last_of('.') + 1);
+    transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)tolower(c); });
+
+    mesh = Mesh();
+    bool ok;
+    if (ext == "obj") ok = loadObj(filename, mesh, faceColor);
+    else if (ext == "ply") ok = loadPly(filename, mesh, faceColor);
+    else {
+        cerr << "Error: " << filename << ": unsupported mesh format (use .obj or .ply)" << endl;
+        return false;
+    }
+    if (!ok || mesh.faces.empty()) {
+        cerr << "Error: could not load mesh " << filename << endl;
+        return false;
+    }
+
+    weldVertices(mesh);
+    return true;
+}
+
+void placeOnBoard(Mesh &mesh, float centerX, float centerY, float size) {
+    if (mesh.numVertices() == 0) return;
+
+    // (x, y, z) Y-up -> (x, z, -y) on the board; a proper rotation, so
+    // face winding is preserved
+    mesh.y.swap(mesh.z);
+    for (float &v : mesh.z) v = -v;
+
+    float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    const vector<float> *axes[3] = {&mesh.x, &mesh.y, &mesh.z};
+    for (int a = 0; a < 3; a++) {
+        for (float v : *axes[a]) {
+            lo[a] = min(lo[a], v);
+            hi[a] = max(hi[a], v);
+        }
+    }
+
+    float extent = max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    float scale = extent > 0 ? size / extent : 1.0f;
+    float midX = (lo[0] + hi[0]) * 0.5f;
+    float midY = (lo[1] + hi[1]) * 0.5f;
+    for (size_t i = 0; i < mesh.numVertices(); i++) {
+        mesh.x[i] = (mesh.x[i] - midX) * scale + centerX;
+        mesh.y[i] = (mesh.y[i] - midY) * scale + centerY;
+        mesh.z[i] = (mesh.z[i] - hi[2]) * scale;  // Lowest point on the board (z = 0)
+    }
+}
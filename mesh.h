@@ -0,0 +1,53 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Mesh (triangle meshes for the AR virtual objects)
+ ---------------------------------------------------------
+ * Indexed triangle mesh in board coordinates (square units, -Z pointing up
+ * off the board). Faces are wound counter-clockwise seen from outside, so the
+ * cross product (v1 - v0) x (v2 - v0) is the outward normal.
+ *
+ * Vertex positions are stored as separate x / y / z arrays (structure of
+ * arrays) so per-frame transforms and culling run as tight, vectorizable
+ * loops. Vertices are deduplicated: each position is stored once and shared
+ * by every face that uses it.
+ *
+ * OBJ (v / f records) and PLY (ASCII or binary little-endian) files can be
+ * loaded; polygons are triangulated as fans.
+ */
+
+#ifndef MESH_H
+#define MESH_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+struct Mesh {
+    std::vector<float> x, y, z;            // Vertex positions (SoA)
+    std::vector<cv::Vec3i> faces;          // Vertex indices per triangle
+    std::vector<cv::Vec3b> faceColors;     // BGR base colour per triangle
+
+    size_t numVertices() const { return x.size(); }
+    cv::Point3f vertex(int i) const { return cv::Point3f(x[i], y[i], z[i]); }
+    int addVertex(const cv::Point3f &p) {
+        x.push_back(p.x);
+        y.push_back(p.y);
+        z.push_back(p.z);
+        return (int)x.size() - 1;
+    }
+};
+
+// Merge vertices with identical positions and drop unused / degenerate data
+void weldVertices(Mesh &mesh);
+
+// Load .obj or .ply (by extension), every face coloured faceColor
+bool loadMesh(const std::string &filename, Mesh &mesh, cv::Vec3b faceColor = cv::Vec3b(170, 200, 230));
+
+// Rotate a Y-up model so +Y points off the board (-Z), scale its largest
+// extent to size and stand it on the board centred at (centerX, centerY)
+void placeOnBoard(Mesh &mesh, float centerX, float centerY, float size);
+
+#endif // MESH_H
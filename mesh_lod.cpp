@@ -0,0 +1,159 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Mesh LOD
+ ---------------------------------------------------------
+ * See mesh_lod.h.
+ */
+
+#include "mesh_lod.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+struct FaceHash {
+    size_t operator()(const Vec3i &f) const {
+        return ((size_t)(unsigned)f[0] * 73856093u) ^ ((size_t)(unsigned)f[1] * 19349663u) ^
+               ((size_t)(unsigned)f[2] * 83492791u);
+    }
+};
+
+struct FaceEqual {
+    bool operator()(const Vec3i &a, const Vec3i &b) const {
+        return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+    }
+};
+
+// Rotate the indices so the smallest comes first; keeps the winding
+Vec3i canonicalFace(const Vec3i &f) {
+    if (f[1] < f[0] && f[1] < f[2]) return Vec3i(f[1], f[2], f[0]);
+    if (f[2] < f[0] && f[2] < f[1]) return Vec3i(f[2], f[0], f[1]);
+    return f;
+}
+
+void meshBounds(const Mesh &mesh, Point3f &lo, Point3f &hi) {
+    lo = Point3f(FLT_MAX, FLT_MAX, FLT_MAX);
+    hi = Point3f(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < mesh.numVertices(); i++) {
+        lo.x = min(lo.x, mesh.x[i]); hi.x = max(hi.x, mesh.x[i]);
+        lo.y = min(lo.y, mesh.y[i]); hi.y = max(hi.y, mesh.y[i]);
+        lo.z = min(lo.z, mesh.z[i]); hi.z = max(hi.z, mesh.z[i]);
+    }
+}
+
+} // namespace
+
+Mesh simplifyByClustering(const Mesh &mesh, int gridResolution) {
+    Mesh out;
+    if (mesh.numVertices() == 0 || gridResolution < 1) return out;
+
+    Point3f lo, hi;
+    meshBounds(mesh, lo, hi);
+    float extent = max({hi.x - lo.x, hi.y - lo.y, hi.z - lo.z});
+    float cell = extent > 0 ? extent / gridResolution : 1.0f;
+    float inv = 1.0f / cell;
+    long long g = gridResolution + 1;
+
+    // Cell of every vertex, and the running sum of each occupied cell
+    unordered_map<long long, int> cellIndex;
+    vector<int> remap(mesh.numVertices());
+    vector<Point3f> sums;
+    vector<int> counts;
+    for (size_t i = 0; i < mesh.numVertices(); i++) {
+        long long cx = (long long)((mesh.x[i] - lo.x) * inv);
+        long long cy = (long long)((mesh.y[i] - lo.y) * inv);
+        long long cz = (long long)((mesh.z[i] - lo.z) * inv);
+        long long key = (cz * g + cy) * g + cx;
+        auto it = cellIndex.emplace(key, (int)sums.size());
+        if (it.second) {
+            sums.push_back(Point3f(0, 0, 0));
+            counts.push_back(0);
+        }
+        int c = it.first->second;
+        sums[c] += mesh.vertex((int)i);
+        counts[c]++;
+        remap[i] = c;
+    }
+    for (size_t c = 0; c < sums.size(); c++) out.addVertex(sums[c] * (1.0f / counts[c]));
+
+    unordered_set<Vec3i, FaceHash, FaceEqual> seen;
+    seen.reserve(mesh.faces.size());
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        Vec3i face(remap[mesh.faces[f][0]], remap[mesh.faces[f][1]], remap[mesh.faces[f][2]]);
+        if (face[0] == face[1] || face[1] == face[2] || face[0] == face[2]) continue;
+        if (!seen.insert(canonicalFace(face)).second) continue;
+        out.faces.push_back(face);
+        out.faceColors.push_back(mesh.faceColors[f]);
+    }
+
+    // Drop cells no surviving face uses
+    weldVertices(out);
+    return out;
+}
+
+MeshLod buildLodChain(const Mesh &mesh, int maxLevels, int minTriangles) {
+    MeshLod lod;
+    lod.levels.push_back({mesh, 0.0f});
+
+    Point3f lo, hi;
+    meshBounds(mesh, lo, hi);
+    lod.center = (lo + hi) * 0.5f;
+    for (size_t i = 0; i < mesh.numVertices(); i++) {
+        Point3f d = mesh.vertex((int)i) - lod.center;
+        lod.radius = max(lod.radius, sqrt(d.dot(d)));
+    }
+    float extent = max({hi.x - lo.x, hi.y - lo.y, hi.z - lo.z});
+    if (extent <= 0) return lod;
+
+    // Halve the grid each step; keep a level only when it removes at least a
+    // quarter of the previous level's triangles
+    for (int grid = 256; grid >= 2 && (int)lod.levels.size() < maxLevels; grid /= 2) {
+        size_t previous = lod.levels.back().mesh.faces.size();
+        if ((int)previous <= minTriangles) break;
+        Mesh simplified = simplifyByClustering(mesh, grid);
+        if (simplified.faces.empty() || simplified.faces.size() > previous * 3 / 4) continue;
+        lod.levels.push_back({std::move(simplified), extent / grid});
+    }
+    return lod;
+}
+
+int LodSelector::select(const MeshLod &lod, const Mat &rvec, const Mat &tvec, const Mat &cameraMatrix) {
+    int numLevels = (int)lod.levels.size();
+    level_ = min(level_, numLevels - 1);
+    if (numLevels <= 1) return level_ = 0;
+
+    // Depth of the bounding-sphere centre in camera space
+    Matx33d R;
+    Rodrigues(rvec, R);
+    Vec3d c = R * Vec3d(lod.center.x, lod.center.y, lod.center.z) + Vec3d(tvec.reshape(1, 3));
+    double fx = cameraMatrix.at<double>(0, 0);
+    if (c[2] <= lod.radius) {
+        // Camera inside or behind the sphere: full detail
+        radiusPixels_ = FLT_MAX;
+        return level_ = 0;
+    }
+    radiusPixels_ = (float)(fx * lod.radius / c[2]);
+    float pixelsPerUnit = (float)(fx / c[2]);
+
+    // Coarsest level within the error budget; coarser than the current level
+    // only with the hysteresis margin
+    int best = 0;
+    for (int k = numLevels - 1; k > 0; k--) {
+        float errorPx = lod.levels[k].error * pixelsPerUnit;
+        float limit = k > level_ ? LOD_PIXEL_ERROR / LOD_HYSTERESIS : LOD_PIXEL_ERROR;
+        if (errorPx <= limit) {
+            best = k;
+            break;
+        }
+    }
+    return level_ = best;
+}
@@ -0,0 +1,61 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Mesh LOD (level-of-detail chain for the AR virtual objects)
+ ---------------------------------------------------------
+ * A loaded mesh is simplified once at load time by vertex clustering: the
+ * bounding box is cut into a grid, every vertex in a cell collapses to the
+ * cell's mean and faces that become degenerate or duplicated are dropped.
+ * Coarser grids give the coarser levels; each level records its cell size
+ * as its geometric error.
+ *
+ * Per frame, the selector projects the bounding sphere with the pose and the
+ * focal length (radius_px = fx * radius / depth) and picks the coarsest level
+ * whose error stays under LOD_PIXEL_ERROR pixels on screen. A level is only
+ * coarsened once it is LOD_HYSTERESIS times below the threshold, so a
+ * model hovering at a boundary does not pop back and forth.
+ */
+
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "mesh.h"
+
+const float LOD_PIXEL_ERROR = 1.5f;  // Largest allowed on-screen simplification error
+const float LOD_HYSTERESIS = 1.5f;   // Margin before switching to a coarser level
+
+struct LodLevel {
+    Mesh mesh;
+    float error = 0.0f;  // Cluster cell size in board units, 0 = full detail
+};
+
+struct MeshLod {
+    std::vector<LodLevel> levels;  // levels[0] is the full mesh, then coarser
+    cv::Point3f center;            // Bounding sphere in board coordinates
+    float radius = 0.0f;
+};
+
+// Simplify by clustering vertices on a grid of gridResolution cells per axis
+Mesh simplifyByClustering(const Mesh &mesh, int gridResolution);
+
+// Full mesh plus successively coarser levels, down to about minTriangles
+MeshLod buildLodChain(const Mesh &mesh, int maxLevels = 6, int minTriangles = 64);
+
+class LodSelector {
+public:
+    // Level to draw this frame for the given pose
+    int select(const MeshLod &lod, const cv::Mat &rvec, const cv::Mat &tvec, const cv::Mat &cameraMatrix);
+
+    int level() const { return level_; }
+    float radiusPixels() const { return radiusPixels_; }
+
+private:
+    int level_ = 0;
+    float radiusPixels_ = 0.0f;
+};
+
+#endif // MESH_LOD_H
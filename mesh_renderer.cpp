@@ -0,0 +1,222 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Mesh Renderer
+ ---------------------------------------------------------
+ * See mesh_renderer.h. Depth is stored as 1/z, which interpolates linearly in
+ * screen space, so the nearest surface has the largest value and an empty
+ * pixel is 0.
+ */
+
+#include "mesh_renderer.h"
+#include "alloc_counter.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+const float NEAR_Z = 1e-3f;          // Triangles reaching closer than this are skipped
+const float AMBIENT = 0.35f;         // Light on faces turned away from the light
+const float FRUSTUM_MARGIN = 0.1f;   // Fraction of the image kept outside the frustum for distortion
+const Vec3f LIGHT_DIR = normalize(Vec3f(-0.3f, -0.5f, -1.0f));  // From the upper left of the camera
+
+inline uint32_t packColor(const Vec3b &bgr, float intensity) {
+    uint32_t b = (uint32_t)min(255.0f, bgr[0] * intensity);
+    uint32_t g = (uint32_t)min(255.0f, bgr[1] * intensity);
+    uint32_t r = (uint32_t)min(255.0f, bgr[2] * intensity);
+    return b | (g << 8) | (r << 16) | (0xFFu << 24);
+}
+
+} // namespace
+
+void MeshRenderer::begin(Size frameSize) {
+    if (depth_.size() != frameSize) {
+        depth_.create(frameSize, CV_32F);
+        overlay_.create(frameSize, CV_8UC4);
+        depth_.setTo(0);
+        overlay_.setTo(Scalar::all(0));
+    } else if (dirty_.area() > 0) {
+        depth_(dirty_).setTo(0);
+        overlay_(dirty_).setTo(Scalar::all(0));
+    }
+    dirty_ = Rect();
+}
+
+void MeshRenderer::rasterize(const Point2f &q0, const Point2f &q1, const Point2f &q2,
+                             float iz0, float iz1, float iz2, uint32_t color) {
+    Point2f p0 = q0, p1 = q1, p2 = q2;
+    float area = (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x);
+    if (fabs(area) < 1e-6f) return;
+    if (area < 0) {
+        swap(p1, p2);
+        swap(iz1, iz2);
+        area = -area;
+    }
+
+    int minX = max(0, (int)floor(min({p0.x, p1.x, p2.x})));
+    int maxX = min(depth_.cols - 1, (int)ceil(max({p0.x, p1.x, p2.x})));
+    int minY = max(0, (int)floor(min({p0.y, p1.y, p2.y})));
+    int maxY = min(depth_.rows - 1, (int)ceil(max({p0.y, p1.y, p2.y})));
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge functions w_i = A_i x + B_i y + C_i, w_i >= 0 inside; w_i is the
+    // weight of vertex i scaled by the area
+    float a0 = p1.y - p2.y, b0 = p2.x - p1.x, c0 = p1.x * p2.y - p1.y * p2.x;
+    float a1 = p2.y - p0.y, b1 = p0.x - p2.x, c1 = p2.x * p0.y - p2.y * p0.x;
+    float a2 = p0.y - p1.y, b2 = p1.x - p0.x, c2 = p0.x * p1.y - p0.y * p1.x;
+    float invArea = 1.0f / area;
+    float za = (a0 * iz0 + a1 * iz1 + a2 * iz2) * invArea;
+    float zb = (b0 * iz0 + b1 * iz1 + b2 * iz2) * invArea;
+    float zc = (c0 * iz0 + c1 * iz1 + c2 * iz2) * invArea;
+
+    float px = minX + 0.5f;
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        float w0Row = a0 * px + b0 * py + c0;
+        float w1Row = a1 * px + b1 * py + c1;
+        float w2Row = a2 * px + b2 * py + c2;
+        float zRow = za * px + zb * py + zc;
+
+        float *depthRow = depth_.ptr<float>(y) + minX;
+        uint32_t *colorRow = overlay_.ptr<uint32_t>(y) + minX;
+        int n = maxX - minX + 1;
+
+        // Branch-free so the compiler can vectorize it
+        for (int i = 0; i < n; i++) {
+            float fx = (float)i;
+            float w0 = w0Row + a0 * fx;
+            float w1 = w1Row + a1 * fx;
+            float w2 = w2Row + a2 * fx;
+            float iz = zRow + za * fx;
+            bool inside = (w0 >= 0.0f) & (w1 >= 0.0f) & (w2 >= 0.0f) & (iz > depthRow[i]);
+            depthRow[i] = inside ? iz : depthRow[i];
+            colorRow[i] = inside ? color : colorRow[i];
+        }
+    }
+
+    dirty_ |= Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+}
+
+void MeshRenderer::composite(Mat &frame) const {
+    for (int y = dirty_.y; y < dirty_.y + dirty_.height; y++) {
+        const uint32_t *src = overlay_.ptr<uint32_t>(y);
+        Vec3b *dst = frame.ptr<Vec3b>(y);
+        for (int x = dirty_.x; x < dirty_.x + dirty_.width; x++) {
+            uint32_t c = src[x];
+            if (c >> 24) dst[x] = Vec3b((uchar)c, (uchar)(c >> 8), (uchar)(c >> 16));
+        }
+    }
+}
+
+void MeshRenderer::render(Mat &frame, const Mesh &mesh, const Mat &rvec, const Mat &tvec,
+                          const Mat &cameraMatrix, const Mat &distCoeffs) {
+    CV_Assert(frame.type() == CV_8UC3);
+    begin(frame.size());
+    stats_ = RenderStats();
+    size_t numVertices = mesh.numVertices();
+    if (mesh.faces.empty() || numVertices == 0) return;
+
+    // Camera-space vertices for culling, depth and normals
+    Matx33d rd;  // Fixed size: no allocation per frame
+    Rodrigues(rvec, rd);
+    Vec3d td(tvec.reshape(1, 3));
+    const float r00 = (float)rd(0, 0), r01 = (float)rd(0, 1), r02 = (float)rd(0, 2);
+    const float r10 = (float)rd(1, 0), r11 = (float)rd(1, 1), r12 = (float)rd(1, 2);
+    const float r20 = (float)rd(2, 0), r21 = (float)rd(2, 1), r22 = (float)rd(2, 2);
+    const float t0 = (float)td[0], t1 = (float)td[1], t2 = (float)td[2];
+
+    cx_.resize(numVertices);
+    cy_.resize(numVertices);
+    cz_.resize(numVertices);
+    const float *mx = mesh.x.data(), *my = mesh.y.data(), *mz = mesh.z.data();
+    float *ox = cx_.data(), *oy = cy_.data(), *oz = cz_.data();
+    for (size_t i = 0; i < numVertices; i++) {
+        ox[i] = r00 * mx[i] + r01 * my[i] + r02 * mz[i] + t0;
+        oy[i] = r10 * mx[i] + r11 * my[i] + r12 * mz[i] + t1;
+        oz[i] = r20 * mx[i] + r21 * my[i] + r22 * mz[i] + t2;
+    }
+
+    // Frustum outcodes against the pinhole model, with a margin for lens
+    // distortion: u = fx x / z + cx is left of the image when fx x + (cx + m) z < 0
+    Matx33d K(cameraMatrix);
+    const float fx = (float)K(0, 0), fy = (float)K(1, 1);
+    const float ppx = (float)K(0, 2), ppy = (float)K(1, 2);
+    const float marginX = FRUSTUM_MARGIN * frame.cols, marginY = FRUSTUM_MARGIN * frame.rows;
+    const float leftK = ppx + marginX, rightK = ppx - frame.cols - marginX;
+    const float topK = ppy + marginY, bottomK = ppy - frame.rows - marginY;
+    outcodes_.resize(numVertices);
+    for (size_t i = 0; i < numVertices; i++) {
+        float x = fx * ox[i], y = fy * oy[i], z = oz[i];
+        outcodes_[i] = (uint8_t)((z < NEAR_Z) |
+                                 ((x + leftK * z < 0) << 1) |
+                                 ((x + rightK * z > 0) << 2) |
+                                 ((y + topK * z < 0) << 3) |
+                                 ((y + bottomK * z > 0) << 4));
+    }
+
+    // Cull faces; remember which vertices the survivors need
+    projectedIndex_.assign(numVertices, -1);
+    visibleFaces_.clear();
+    survivors_.clear();
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        const Vec3i &face = mesh.faces[f];
+        int i0 = face[0], i1 = face[1], i2 = face[2];
+        uint8_t c0 = outcodes_[i0], c1 = outcodes_[i1], c2 = outcodes_[i2];
+        // Entirely outside one plane, or crossing the near plane (not clipped)
+        if ((c0 & c1 & c2) || ((c0 | c1 | c2) & 1)) {
+            stats_.frustumCulled++;
+            continue;
+        }
+
+        // Back-facing when the outward normal points away from the camera
+        float e1x = ox[i1] - ox[i0], e1y = oy[i1] - oy[i0], e1z = oz[i1] - oz[i0];
+        float e2x = ox[i2] - ox[i0], e2y = oy[i2] - oy[i0], e2z = oz[i2] - oz[i0];
+        float nx = e1y * e2z - e1z * e2y;
+        float ny = e1z * e2x - e1x * e2z;
+        float nz = e1x * e2y - e1y * e2x;
+        if (nx * ox[i0] + ny * oy[i0] + nz * oz[i0] >= 0) {
+            stats_.backfaceCulled++;
+            continue;
+        }
+
+        visibleFaces_.push_back((int)f);
+        for (int k = 0; k < 3; k++) {
+            int v = face[k];
+            if (projectedIndex_[v] < 0) {
+                projectedIndex_[v] = (int)survivors_.size();
+                survivors_.push_back(mesh.vertex(v));
+            }
+        }
+    }
+    if (visibleFaces_.empty()) return;
+
+    {
+        AllocationScope scope("projectPoints");
+        projectPoints(survivors_, rvec, tvec, cameraMatrix, distCoeffs, imagePoints_);
+    }
+    stats_.verticesProjected = (int)survivors_.size();
+
+    for (int f : visibleFaces_) {
+        const Vec3i &face = mesh.faces[f];
+        int i0 = face[0], i1 = face[1], i2 = face[2];
+
+        // Flat Lambert shading from the outward face normal
+        Point3f v0(ox[i0], oy[i0], oz[i0]);
+        Point3f n = (Point3f(ox[i1], oy[i1], oz[i1]) - v0).cross(Point3f(ox[i2], oy[i2], oz[i2]) - v0);
+        float len = sqrt(n.dot(n));
+        if (len <= 0) continue;
+        float lambert = max(0.0f, (n.x * LIGHT_DIR[0] + n.y * LIGHT_DIR[1] + n.z * LIGHT_DIR[2]) / len);
+        uint32_t color = packColor(mesh.faceColors[f], AMBIENT + (1.0f - AMBIENT) * lambert);
+
+        rasterize(imagePoints_[projectedIndex_[i0]], imagePoints_[projectedIndex_[i1]],
+                  imagePoints_[projectedIndex_[i2]], 1.0f / oz[i0], 1.0f / oz[i1], 1.0f / oz[i2], color);
+        stats_.trianglesDrawn++;
+    }
+
+    composite(frame);
+}
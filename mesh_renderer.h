@@ -0,0 +1,66 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Mesh Renderer (CPU triangle rasterizer for AR overlays)
+ ---------------------------------------------------------
+ * Draws filled, z-buffered triangles with flat Lambert shading instead of
+ * wireframe edges, so hidden surfaces stay hidden. Triangles are rasterized
+ * with incremental edge functions into a preallocated overlay (packed 32-bit
+ * colour + 1/z depth) whose inner loop is branch-free and auto-vectorizes.
+ * Only the union of the projected triangle bounds is cleared and
+ * composited, so cost follows the object's screen size, not the frame size.
+ *
+ * Before projection, faces are culled in camera space from the current
+ * rvec/tvec: back-facing triangles, and triangles whose vertices all lie
+ * outside the same side of the view frustum. Only vertices used by the
+ * surviving faces are passed to projectPoints.
+ *
+ * Not thread-safe: use one renderer per thread.
+ */
+
+#ifndef MESH_RENDERER_H
+#define MESH_RENDERER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "mesh.h"
+
+struct RenderStats {
+    int trianglesDrawn = 0;
+    int backfaceCulled = 0;
+    int frustumCulled = 0;
+    int verticesProjected = 0;
+};
+
+class MeshRenderer {
+public:
+    // Transform, project, shade and rasterize mesh, then composite onto frame
+    void render(cv::Mat &frame, const Mesh &mesh, const cv::Mat &rvec, const cv::Mat &tvec,
+                const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs);
+
+    const RenderStats &stats() const { return stats_; }
+
+private:
+    void begin(cv::Size frameSize);
+    void rasterize(const cv::Point2f &p0, const cv::Point2f &p1, const cv::Point2f &p2,
+                   float iz0, float iz1, float iz2, uint32_t color);
+    void composite(cv::Mat &frame) const;
+
+    cv::Mat depth_;     // CV_32F, 1/z, 0 = empty
+    cv::Mat overlay_;   // CV_8UC4, BGR + coverage flag
+    cv::Rect dirty_;    // Area touched since the last clear
+
+    // Per-frame scratch, reused between frames
+    std::vector<float> cx_, cy_, cz_;        // Camera-space vertices (SoA)
+    std::vector<uint8_t> outcodes_;          // Frustum planes each vertex is outside of
+    std::vector<int> projectedIndex_;        // Vertex -> slot in imagePoints_, -1 = unused
+    std::vector<int> visibleFaces_;
+    std::vector<cv::Point3f> survivors_;
+    std::vector<cv::Point2f> imagePoints_;
+    RenderStats stats_;
+};
+
+#endif // MESH_RENDERER_H
@@ -0,0 +1,112 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Plane Overlay
+ ---------------------------------------------------------
+ * See plane_overlay.h.
+ */
+
+#include "plane_overlay.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+void PlaneOverlay::setTexture(const Mat &texture) {
+    if (texture.empty()) {
+        texture_.release();
+        mask_.release();
+        return;
+    }
+
+    if (texture.channels() == 4) {
+        cvtColor(texture, texture_, COLOR_BGRA2BGR);
+        extractChannel(texture, mask_, 3);
+        maskFromAlpha_ = true;
+        return;
+    }
+
+    if (texture.channels() == 1) cvtColor(texture, texture_, COLOR_GRAY2BGR);
+    else texture.copyTo(texture_);
+
+    // A solid mask only depends on the size
+    if (maskFromAlpha_ || mask_.size() != texture_.size()) {
+        mask_.create(texture_.size(), CV_8UC1);
+        mask_.setTo(255);
+        maskFromAlpha_ = false;
+    }
+}
+
+void PlaneOverlay::draw(Mat &frame, const Mat &H, const Rect2f &region) {
+    if (texture_.empty() || H.empty()) return;
+    int64 start = getTickCount();
+
+    // Texture pixels -> reference region -> frame
+    Matx33d A(region.width / texture_.cols, 0, region.x,
+              0, region.height / texture_.rows, region.y,
+              0, 0, 1);
+    Matx33d forward = Matx33d(H) * A;
+
+    vector<Point2f> corners = {
+        Point2f(0, 0), Point2f((float)texture_.cols, 0),
+        Point2f((float)texture_.cols, (float)texture_.rows), Point2f(0, (float)texture_.rows)
+    };
+    vector<Point2f> projected;
+    perspectiveTransform(corners, projected, Mat(forward));
+
+    Rect roi = boundingRect(projected) & Rect(0, 0, frame.cols, frame.rows);
+    if (roi.area() == 0) return;
+
+    // Fixed-point inverse maps for the ROI only, as convertMaps would produce
+    Matx33d inv = forward.inv();
+    mapXY_.create(roi.size(), CV_16SC2);
+    mapA_.create(roi.size(), CV_16UC1);
+    const double scale = INTER_TAB_SIZE;
+    for (int y = 0; y < roi.height; y++) {
+        double fy = roi.y + y;
+        double X = inv(0, 0) * roi.x + inv(0, 1) * fy + inv(0, 2);
+        double Y = inv(1, 0) * roi.x + inv(1, 1) * fy + inv(1, 2);
+        double W = inv(2, 0) * roi.x + inv(2, 1) * fy + inv(2, 2);
+        short *xy = mapXY_.ptr<short>(y);
+        ushort *a = mapA_.ptr<ushort>(y);
+        for (int x = 0; x < roi.width; x++) {
+            double w = W > 0 ? scale / W : 0;
+            // Behind the horizon maps far outside the texture (border = transparent)
+            int ix = W > 0 ? saturate_cast<int>(X * w) : INT_MIN / 2;
+            int iy = W > 0 ? saturate_cast<int>(Y * w) : INT_MIN / 2;
+            xy[2 * x] = saturate_cast<short>(ix >> INTER_BITS);
+            xy[2 * x + 1] = saturate_cast<short>(iy >> INTER_BITS);
+            a[x] = (ushort)((iy & (INTER_TAB_SIZE - 1)) * INTER_TAB_SIZE + (ix & (INTER_TAB_SIZE - 1)));
+            X += inv(0, 0);
+            Y += inv(1, 0);
+            W += inv(2, 0);
+        }
+    }
+
+    remap(texture_, warped_, mapXY_, mapA_, INTER_LINEAR, BORDER_CONSTANT);
+    remap(mask_, warpedMask_, mapXY_, mapA_, INTER_LINEAR, BORDER_CONSTANT);
+
+    // Alpha blend inside the ROI; bilinear mask edges give antialiased borders
+    for (int y = 0; y < roi.height; y++) {
+        const Vec3b *src = warped_.ptr<Vec3b>(y);
+        const uchar *alpha = warpedMask_.ptr<uchar>(y);
+        Vec3b *dst = frame.ptr<Vec3b>(roi.y + y) + roi.x;
+        for (int x = 0; x < roi.width; x++) {
+            int al = alpha[x];
+            if (al == 0) continue;
+            if (al == 255) {
+                dst[x] = src[x];
+                continue;
+            }
+            for (int c = 0; c < 3; c++) {
+                dst[x][c] = (uchar)((src[x][c] * al + dst[x][c] * (255 - al) + 127) / 255);
+            }
+        }
+    }
+
+    lastMs_ = (getTickCount() - start) * 1000.0 / getTickFrequency();
+}
@@ -0,0 +1,49 @@
+/*
+ * Ishan Chaudhary, Bhumika Yadav
+ * Fall 2025
+ * CS 5330 Computer Vision
+
+  Plane Overlay (perspective texture on a tracked plane)
+ ---------------------------------------------------------
+ * Composites an image or video frame onto the quad a homography maps it to.
+ * Instead of warping the texture over the whole frame, only the quad's
+ * bounding box is touched: fixed-point coordinate maps (the CV_16SC2 +
+ * CV_16UC1 format remap uses natively) are generated row by row for that
+ * box, the texture and its precomputed mask are remapped through them, and
+ * the result is alpha-blended in place. The mask comes from the texture's
+ * alpha channel, or is solid, and is rebuilt only when the texture size
+ * changes, so video textures cost one copy per frame.
+ *
+ * Map and warp buffers are kept between frames.
+ */
+
+#ifndef PLANE_OVERLAY_H
+#define PLANE_OVERLAY_H
+
+#include <opencv2/opencv.hpp>
+
+class PlaneOverlay {
+public:
+    // BGR, or BGRA whose alpha becomes the blend mask
+    void setTexture(const cv::Mat &texture);
+    bool hasTexture() const { return !texture_.empty(); }
+
+    // Draw the texture onto the quad that region (reference-image
+    // coordinates) maps to through H (reference -> frame)
+    void draw(cv::Mat &frame, const cv::Mat &H, const cv::Rect2f &region);
+
+    double lastMs() const { return lastMs_; }
+
+private:
+    cv::Mat texture_;     // CV_8UC3
+    cv::Mat mask_;        // CV_8UC1, 255 = opaque
+    bool maskFromAlpha_ = false;
+
+    cv::Mat mapXY_;       // CV_16SC2 integer source coordinates
+    cv::Mat mapA_;        // CV_16UC1 interpolation table index
+    cv::Mat warped_;
+    cv::Mat warpedMask_;
+    double lastMs_ = 0.0;
+};
+
+#endif // PLANE_OVERLAY_H
@@ -7,42 +7,41 @@
   Projects 3D axes and checkerboard corners back into the image using the camera’s calibration parameters. 
   Displays the reprojected axes aligned with the detected checkerboard in real time, and 
   saves screenshots showing correct alignment between 3D projections and image corners.
+
+  Usage: project_axes [--camera-id <id>]   (intrinsics from camera_intrinsics.store,
+         camera_intrinsics.yml for the default camera)
+                     [--replay <file.frec> [--replay-fast]] [--record <file.frec> [--record-png]]
+                     [--luma]   (capture YUYV/NV12, detect on the luma plane)
+                     [--fps <rate>] [--degrade]   (pace to a target rate; detect at
+                     reduced resolution while frames run over budget)
+                     [--detector classic|sb|auto]   (board detector, see board_detector.h)
+                     [--subpix gradient|saddle]     (corner refinement, see board_subpix.h)
+                     [--assert-no-alloc]   (fail if the loop allocates, see alloc_counter.h)
 */
 
 
 #include <opencv2/opencv.hpp>
+#include "intrinsics_store.h"
+#include "board_detection.h"
+#include "board_detector.h"
+#include "frame_recording.h"
+#include "alloc_counter.h"
+#include "frame_scheduler.h"
 #include <iostream>
 #include <vector>
+#include <string>
 
 using namespace cv;
 using namespace std;
 
-// Function to read camera parameters from a YAML file
-bool readCameraParameters(const string &filename, Mat &cameraMatrix, Mat &distCoeffs) {
-    FileStorage fs(filename, FileStorage::READ);
-    if (!fs.isOpened()) {
-        cerr << "Failed to open camera parameters file: " << filename << endl;
-        return false;
-    }
-    fs["camera_matrix"] >> cameraMatrix;
-    fs["distortion_coefficients"] >> distCoeffs;
-    fs.release();
-    return true;
-}
-
-int main() {
+int main(int argc, char** argv) {
     // Checkerboard dimensions
     const int boardWidth = 9;
     const int boardHeight = 6;
     const float squareSize = 1.0f;
 
     // Prepare 3D object points for checkerboard corners
-    vector<Point3f> objectPoints;
-    for (int i = 0; i < boardHeight; i++) {
-        for (int j = 0; j < boardWidth; j++) {
-            objectPoints.push_back(Point3f(j*squareSize, i*squareSize, 0));
-        }
-    }
+    vector<Point3f> objectPoints = boardObjectPoints(Size(boardWidth, boardHeight), squareSize);
 
     // Define 3D points to project: 4 corners
     vector<Point3f> corners3D;
@@ -51,73 +50,103 @@ int main() {
     corners3D.push_back(Point3f(0,(boardHeight-1)*squareSize,0)); // bottom-left
     corners3D.push_back(Point3f((boardWidth-1)*squareSize,(boardHeight-1)*squareSize,0)); // bottom-right
 
-    // Load camera calibration
-    Mat cameraMatrix, distCoeffs;
-    if (!readCameraParameters("camera_intrinsics.yml", cameraMatrix, distCoeffs)) {
-        return -1;
-    }
+    // Camera calibration, looked up once the capture resolution is known
+    string cameraId = cameraIdFromArgs(argc, argv);
+    CameraIntrinsics intrinsics;
+    Mat distCoeffs;
+    Mat cameraMatrix;
+    Size cameraMatrixSize;  // Frame size cameraMatrix was scaled for
 
-    VideoCapture cap(0);
-    if (!cap.isOpened()) {
+    // Camera 0, or a recording (--replay)
+    FrameSource cap;
+    if (!cap.open(argc, argv, 0)) {
         cerr << "Cannot open camera" << endl;
         return -1;
     }
 
     bool screenshotTaken = false; 
 
-    while (true) {
-        Mat frame, gray;
-        cap >> frame;
-        if (frame.empty()) break;
-
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
+    // Working set reused every frame: the loop does not allocate once warm
+    FramePyramid pyramid;  // Level buffers persist across frames
+    LumaFrame luma;  // Gray for detection, BGR for drawing
+    vector<Point2f> corners2D;
+    vector<Point2f> projectedPoints;
+    Mat rvec, tvec;
+    FrameAllocationMonitor allocations("project_axes");
+    allocations.configure(argc, argv);
+    FrameScheduler scheduler;
+    scheduler.configure(argc, argv, cap.fps());
+    unique_ptr<BoardDetector> detector = createBoardDetector(argc, argv);
 
-        vector<Point2f> corners2D;
-        bool found = findChessboardCorners(gray, Size(boardWidth, boardHeight), corners2D,
-                                           CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
+    while (true) {
+        allocations.beginFrame();
+        cap >> luma;
+        scheduler.beginFrame();  // Processing time starts once the frame is in
+        if (luma.empty()) break;
+        pyramid.reset(luma.gray());
+        Mat &frame = luma.bgr();
+
+        // Intrinsics follow the capture resolution: its own calibration if
+        // there is one, else the closest one rescaled
+        if (frame.size() != cameraMatrixSize) {
+            if (!loadCameraIntrinsics(cameraId, frame.size(), intrinsics)) return -1;
+            cameraMatrix = scaledCameraMatrix(intrinsics, frame.size());
+            distCoeffs = intrinsics.distCoeffs;
+            cameraMatrixSize = frame.size();
+        }
 
+        // Smaller pyramid level while frames run over budget
+        detector->setMaxDetectionWidth(scheduler.degraded() ? reducedDetectionWidth(frame.cols)
+                                                            : DEFAULT_DETECTION_WIDTH);
+        bool found = detector->detect(pyramid, Size(boardWidth, boardHeight), corners2D);
         if (found) {
-            cornerSubPix(gray, corners2D, Size(11,11), Size(-1,-1),
-                         TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.1));
-
-            drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners2D, found);
-
-            Mat rvec, tvec;
-            solvePnP(objectPoints, corners2D, cameraMatrix, distCoeffs, rvec, tvec);
-
+            {
+                AllocationScope scope("solvePnP");
+                solvePnP(objectPoints, corners2D, cameraMatrix, distCoeffs, rvec, tvec);
+            }
             // Project the 4 corners
-            vector<Point2f> projectedPoints;
+            AllocationScope scope("projectPoints");
             projectPoints(corners3D, rvec, tvec, cameraMatrix, distCoeffs, projectedPoints);
+        }
+
+        if (found) {
+            {
+                AllocationScope scope("drawChessboardCorners");
+                drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners2D, found);
+            }
 
             // Draw the projected points
-            for (size_t i = 0; i < projectedPoints.size(); i++) {
-                circle(frame, projectedPoints[i], 8, Scalar(0,255,255), -1); // yellow dots
+            {
+                AllocationScope scope("circle");
+                for (size_t i = 0; i < projectedPoints.size(); i++) {
+                    circle(frame, projectedPoints[i], 8, Scalar(0,255,255), -1); // yellow dots
+                }
             }
 
             // Draw 3D axes from the origin
-            vector<Point3f> axisPoints = {Point3f(0,0,0), Point3f(3*squareSize,0,0),
-                                          Point3f(0,3*squareSize,0), Point3f(0,0,-3*squareSize)};
-            vector<Point2f> imagePoints;
-            projectPoints(axisPoints, rvec, tvec, cameraMatrix, distCoeffs, imagePoints);
-
-            line(frame, imagePoints[0], imagePoints[1], Scalar(0,0,255), 2); // X-axis red
-            line(frame, imagePoints[0], imagePoints[2], Scalar(0,255,0), 2); // Y-axis green
-            line(frame, imagePoints[0], imagePoints[3], Scalar(255,0,0), 2); // Z-axis blue
+            drawPoseAxes(frame, rvec, tvec, cameraMatrix, distCoeffs, 3 * squareSize);
 
             // Save a screenshot once
             if (!screenshotTaken) {
+                AllocationScope scope("imwrite");
                 imwrite("checkerboard_axes_screenshot.png", frame);
                 cout << "Screenshot saved as checkerboard_axes_screenshot.png" << endl;
                 screenshotTaken = true;
             }
         }
 
-        imshow("Projected 3D Corners and Axes", frame);
-        char key = (char)waitKey(30);
+        {
+            AllocationScope scope("imshow");
+            imshow("Projected 3D Corners and Axes", frame);
+        }
+        char key = (char)scheduler.waitKey();
         if (key == 27) break; // ESC
+        allocations.endFrame();
     }
 
+    cout << "Timing: " << scheduler.summary() << endl;
+
     cap.release();
     destroyAllWindows();
-    return 0;
+    return allocations.finish() ? 0 : 1;
 }
@@ -12,13 +12,20 @@
 
   Ensures that a sufficient number of diverse viewpoints are
   collected for accurate camera parameter estimation.
+
+  Usage: select_calibration_images [--replay <file.frec> [--replay-fast]]
+                                   [--record <file.frec> [--record-png]]
+                                   [--detector classic|sb|auto]   (see board_detector.h)
+                                   [--subpix gradient|saddle]     (corner refinement, board_subpix.h)
 */
 
 #include <opencv2/opencv.hpp>
+#include "board_detector.h"
+#include "frame_recording.h"
 #include <iostream>
 #include <vector>
 
-int main() {
+int main(int argc, char** argv) {
     // Define checkerboard dimensions (number of internal corners)
     const int CHECKERBOARD[2]{9, 6};  // 9 columns, 6 rows
 
@@ -35,41 +42,42 @@ int main() {
     }
 
     // Initialize camera
-    cv::VideoCapture cap(0);
-    if (!cap.isOpened()) {
+    FrameSource cap;
+    if (!cap.open(argc, argv, 0)) {
         std::cerr << "Error: Could not open the camera.\n";
         return -1;
     }
 
     std::cout << "Press 's' to save a calibration frame, 'q' to quit.\n";
 
-    cv::Mat frame, gray;
+    LumaFrame frame;  // Gray for detection, BGR converted only for display and saving
     std::vector<cv::Point2f> corner_set;
     bool found = false;
 
+    // Full-resolution search; corners come back subpixel-refined
+    std::unique_ptr<BoardDetector> detector = createBoardDetector(argc, argv,
+        cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_FAST_CHECK | cv::CALIB_CB_NORMALIZE_IMAGE);
+    detector->setMaxDetectionWidth(0);
+    FramePyramid pyramid;
+
     while (true) {
         cap >> frame;
         if (frame.empty()) break;
 
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        pyramid.reset(frame.gray());
 
         // Find the chessboard corners
-        found = cv::findChessboardCorners(gray, cv::Size(CHECKERBOARD[0], CHECKERBOARD[1]), corner_set,
-                                          cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_FAST_CHECK | cv::CALIB_CB_NORMALIZE_IMAGE);
+        found = detector->detect(pyramid, cv::Size(CHECKERBOARD[0], CHECKERBOARD[1]), corner_set);
 
         if (found) {
-            // Refine corner positions
-            cv::cornerSubPix(gray, corner_set, cv::Size(11, 11), cv::Size(-1, -1),
-                             cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.001));
-
             // Draw corners on the frame
-            cv::drawChessboardCorners(frame, cv::Size(CHECKERBOARD[0], CHECKERBOARD[1]), corner_set, found);
+            cv::drawChessboardCorners(frame.bgr(), cv::Size(CHECKERBOARD[0], CHECKERBOARD[1]), corner_set, found);
 
             std::cout << "Corners found: " << corner_set.size()
                       << " | First corner: (" << corner_set[0].x << ", " << corner_set[0].y << ")\n";
         }
 
-        cv::imshow("Calibration", frame);
+        cv::imshow("Calibration", frame.bgr());
         char key = (char)cv::waitKey(1);
 
         // --- SAVE CALIBRATION FRAME ---
@@ -82,7 +90,7 @@ int main() {
 
                 // save the image
                 std::string filename = "calib_frame_" + std::to_string(corner_list.size()) + ".jpg";
-                cv::imwrite(filename, frame);
+                cv::imwrite(filename, frame.bgr());
                 std::cout << "Saved image: " << filename << "\n";
             } else {
                 std::cout << "No checkerboard detected — frame not saved.\n";
@@ -5,35 +5,77 @@
  * 
  Task 6: Virtual Object Projection
  ---------------------------------------------------------
- * Projects 3D virtual house with pyramid roof onto checkerboard pattern.
- * Supports both live camera and static image modes with auto-scaling calibration.
+ * Projects 3D virtual house with pyramid roof onto checkerboard pattern, drawn
+ * as flat-shaded filled faces by the z-buffered rasterizer in mesh_renderer.
+ * Supports both live camera and static image modes with auto-scaling calibration:
+ * each frame size uses its own calibration from the store when there is one,
+ * else the closest calibration rescaled to it, and
+ * boards in large frames are found on a downscaled copy then refined at full size.
  * 
  * Usage: task6_virtual_object.exe [image_path]
+ *        task6_virtual_object.exe --batch <dir|list.txt> [--jobs N] [--out dir] [--manifest file]
+ *        Any mode accepts --camera-id <id> to pick intrinsics from camera_intrinsics.store.
+ *        Live mode accepts --dev-root <dir> to enumerate cameras under dir instead of /dev.
+ *        --mesh <model.obj|model.ply> replaces the house with a loaded model (Y-up).
+ *        Meshes get a level-of-detail chain; the level follows the on-screen size.
+ *        Live mode accepts --replay <file.frec> [--replay-fast] to run on a recording
+ *        instead of the camera, and --record <file.frec> [--record-png] to make one.
+ *        --luma captures YUYV/NV12 and detects on the luma plane.
+ *        --fps <rate> paces the live loop to a target rate (default: the source's);
+ *        --degrade detects at reduced resolution while frames run over budget.
+ *        --detector classic|sb|auto picks the board detector in every mode (board_detector.h),
+ *        --subpix gradient|saddle its corner refinement (board_subpix.h).
+ *        --assert-no-alloc fails a live run whose loop allocates (alloc_counter.h).
  * Controls: ESC=Exit, s=Screenshot
  */
 
 #include <opencv2/opencv.hpp>
+#include "intrinsics_store.h"
+#include "board_detection.h"
+#include "board_detector.h"
+#include "batch_pipeline.h"
+#include "camera_inventory.h"
+#include "mesh_renderer.h"
+#include "mesh_lod.h"
+#include "frame_recording.h"
+#include "alloc_counter.h"
+#include "frame_scheduler.h"
+#include <cstdio>
 #include <iostream>
 #include <vector>
 
 using namespace cv;
 using namespace std;
 
-// Read camera calibration from YAML file
-bool readCameraParameters(const string &filename, Mat &cameraMatrix, Mat &distCoeffs) {
-    FileStorage fs(filename, FileStorage::READ);
-    if (!fs.isOpened()) {
-        cerr << "Failed to open camera parameters file: " << filename << endl;
-        return false;
+// Add triangle a-b-c, wound so its normal points along outward
+static void addTriangle(Mesh &mesh, Point3f a, Point3f b, Point3f c, Point3f outward, Vec3b color) {
+    if ((b - a).cross(c - a).dot(outward) < 0) swap(b, c);
+    mesh.faces.push_back(Vec3i(mesh.addVertex(a), mesh.addVertex(b), mesh.addVertex(c)));
+    mesh.faceColors.push_back(color);
+}
+
+// Quad a-b-c-d (in order around its edge) as two triangles
+static void addQuad(Mesh &mesh, Point3f a, Point3f b, Point3f c, Point3f d, Point3f outward, Vec3b color) {
+    addTriangle(mesh, a, b, c, outward, color);
+    addTriangle(mesh, a, c, d, outward, color);
+}
+
+// Axis-aligned box between two opposite corners
+static void addBox(Mesh &mesh, Point3f lo, Point3f hi, Vec3b color) {
+    Point3f p[8];
+    for (int i = 0; i < 8; i++) {
+        p[i] = Point3f((i & 1) ? hi.x : lo.x, (i & 2) ? hi.y : lo.y, (i & 4) ? hi.z : lo.z);
     }
-    fs["camera_matrix"] >> cameraMatrix;
-    fs["distortion_coefficients"] >> distCoeffs;
-    fs.release();
-    return true;
+    addQuad(mesh, p[0], p[2], p[6], p[4], Point3f(-1, 0, 0), color);
+    addQuad(mesh, p[1], p[3], p[7], p[5], Point3f(1, 0, 0), color);
+    addQuad(mesh, p[0], p[1], p[5], p[4], Point3f(0, -1, 0), color);
+    addQuad(mesh, p[2], p[3], p[7], p[6], Point3f(0, 1, 0), color);
+    addQuad(mesh, p[0], p[1], p[3], p[2], Point3f(0, 0, -1), color);
+    addQuad(mesh, p[4], p[5], p[7], p[6], Point3f(0, 0, 1), color);
 }
 
-// Create 3D house structure (base, walls, roof, chimney, door)
-void createVirtualObject(vector<pair<Point3f, Point3f>> &lines) {
+// Create 3D house mesh (base, walls, roof, chimney, door)
+void createVirtualObject(Mesh &mesh) {
     
     float centerX = 4.5f;
     float centerY = 2.5f;
@@ -42,18 +84,17 @@ void createVirtualObject(vector<pair<Point3f, Point3f>> &lines) {
     float wallHeight = 3.0f;
     float roofHeight = 3.0f;
     
+    const Vec3b wallColor(170, 200, 230);
+    const Vec3b roofColor(40, 60, 170);
+    const Vec3b chimneyColor(60, 60, 110);
+    const Vec3b doorColor(30, 70, 110);
+    
     // Base square corners
     Point3f base_tl(centerX - baseSize/2, centerY - baseSize/2, baseZ);
     Point3f base_tr(centerX + baseSize/2, centerY - baseSize/2, baseZ);
     Point3f base_bl(centerX - baseSize/2, centerY + baseSize/2, baseZ);
     Point3f base_br(centerX + baseSize/2, centerY + baseSize/2, baseZ);
     
-    // Base square edges
-    lines.push_back({base_tl, base_tr});
-    lines.push_back({base_tr, base_br});
-    lines.push_back({base_br, base_bl});
-    lines.push_back({base_bl, base_tl});
-    
     // Wall corners
     float wallTop = baseZ - wallHeight;
     Point3f wall_tl(centerX - baseSize/2, centerY - baseSize/2, wallTop);
@@ -61,52 +102,101 @@ void createVirtualObject(vector<pair<Point3f, Point3f>> &lines) {
     Point3f wall_bl(centerX - baseSize/2, centerY + baseSize/2, wallTop);
     Point3f wall_br(centerX + baseSize/2, centerY + baseSize/2, wallTop);
     
-    // Vertical wall edges
-    lines.push_back({base_tl, wall_tl});
-    lines.push_back({base_tr, wall_tr});
-    lines.push_back({base_bl, wall_bl});
-    lines.push_back({base_br, wall_br});
-    
-    // Top of walls square
-    lines.push_back({wall_tl, wall_tr});
-    lines.push_back({wall_tr, wall_br});
-    lines.push_back({wall_br, wall_bl});
-    lines.push_back({wall_bl, wall_tl});
+    // Floor and walls
+    addQuad(mesh, base_tl, base_tr, base_br, base_bl, Point3f(0, 0, 1), wallColor);
+    addQuad(mesh, base_tl, base_tr, wall_tr, wall_tl, Point3f(0, -1, 0), wallColor);
+    addQuad(mesh, base_tr, base_br, wall_br, wall_tr, Point3f(1, 0, 0), wallColor);
+    addQuad(mesh, base_br, base_bl, wall_bl, wall_br, Point3f(0, 1, 0), wallColor);
+    addQuad(mesh, base_bl, base_tl, wall_tl, wall_bl, Point3f(-1, 0, 0), wallColor);
     
     // Pyramid roof
     float roofApexZ = wallTop - roofHeight;
     Point3f apex(centerX + 0.5f, centerY - 0.3f, roofApexZ);
+    addTriangle(mesh, wall_tl, wall_tr, apex, Point3f(0, -1, -1), roofColor);
+    addTriangle(mesh, wall_tr, wall_br, apex, Point3f(1, 0, -1), roofColor);
+    addTriangle(mesh, wall_br, wall_bl, apex, Point3f(0, 1, -1), roofColor);
+    addTriangle(mesh, wall_bl, wall_tl, apex, Point3f(-1, 0, -1), roofColor);
     
-    // Roof edges
-    lines.push_back({wall_tl, apex});
-    lines.push_back({wall_tr, apex});
-    lines.push_back({wall_bl, apex});
-    lines.push_back({wall_br, apex});
-    
-    // Chimney
+    // Chimney, rising from the wall top through the roof
     float chimneyWidth = 0.6f;
     float chimneyHeight = 1.5f;
-    Point3f chimney_base1(centerX + baseSize/2 - 1.0f, centerY - baseSize/2, wallTop);
-    Point3f chimney_base2(centerX + baseSize/2 - 1.0f + chimneyWidth, centerY - baseSize/2, wallTop);
-    Point3f chimney_top1(centerX + baseSize/2 - 1.0f, centerY - baseSize/2, wallTop - chimneyHeight);
-    Point3f chimney_top2(centerX + baseSize/2 - 1.0f + chimneyWidth, centerY - baseSize/2, wallTop - chimneyHeight);
-    
-    lines.push_back({chimney_base1, chimney_top1});
-    lines.push_back({chimney_base2, chimney_top2});
-    lines.push_back({chimney_top1, chimney_top2});
+    float chimneyX = centerX + baseSize/2 - 1.0f;
+    float chimneyY = centerY - baseSize/2;
+    addBox(mesh, Point3f(chimneyX, chimneyY, wallTop - chimneyHeight),
+           Point3f(chimneyX + chimneyWidth, chimneyY + chimneyWidth, wallTop), chimneyColor);
     
-    // Door
+    // Door, just in front of the front wall to avoid depth fighting
     float doorWidth = 1.0f;
     float doorHeight = 1.8f;
-    Point3f door_bl(centerX - doorWidth/2, centerY + baseSize/2, baseZ);
-    Point3f door_br(centerX + doorWidth/2, centerY + baseSize/2, baseZ);
-    Point3f door_tl(centerX - doorWidth/2, centerY + baseSize/2, baseZ - doorHeight);
-    Point3f door_tr(centerX + doorWidth/2, centerY + baseSize/2, baseZ - doorHeight);
-    
-    lines.push_back({door_bl, door_tl});
-    lines.push_back({door_br, door_tr});
-    lines.push_back({door_tl, door_tr});
-    lines.push_back({door_bl, door_br});
+    float doorY = centerY + baseSize/2 + 0.01f;
+    Point3f door_bl(centerX - doorWidth/2, doorY, baseZ);
+    Point3f door_br(centerX + doorWidth/2, doorY, baseZ);
+    Point3f door_tl(centerX - doorWidth/2, doorY, baseZ - doorHeight);
+    Point3f door_tr(centerX + doorWidth/2, doorY, baseZ - doorHeight);
+    addQuad(mesh, door_bl, door_br, door_tr, door_tl, Point3f(0, 1, 0), doorColor);
+    
+    // Share corners between faces
+    weldVertices(mesh);
+}
+
+// "LOD 1/4  1234 verts  2000 tris  r=85px" for the overlay and manifest.
+// Written into text in place so the live loop reuses its capacity.
+static void renderMetrics(string &text, const LodSelector &selector, const MeshLod &lod, const RenderStats &stats) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "LOD %d/%d  %d verts  %d tris  r=%dpx",
+             selector.level(), (int)lod.levels.size() - 1, stats.verticesProjected,
+             stats.trianglesDrawn, (int)min(selector.radiusPixels(), 1e6f));
+    text.assign(buffer);
+}
+
+// Detect the board in a still image and draw the house and axes on it.
+// Intrinsics are rescaled when the image differs from the calibration size.
+bool renderStaticImage(Mat &frame, BoardDetector &detector, const vector<Point3f> &objectPoints,
+                       const CameraIntrinsics &intrinsics,
+                       const MeshLod &virtualObject, float squareSize, string *metrics = nullptr) {
+    const int boardWidth = 9;
+    const int boardHeight = 6;
+    
+    Mat gray;
+    cvtColor(frame, gray, COLOR_BGR2GRAY);
+    
+    // Detect checkerboard (on a pyramid level for large images, refined at full resolution)
+    FramePyramid pyramid;
+    pyramid.reset(gray);
+    vector<Point2f> corners2D;
+    bool found = detector.detect(pyramid, Size(boardWidth, boardHeight), corners2D);
+    if (!found) return false;
+    
+    // Auto-scale calibration for different resolutions
+    Mat scaledCamMatrix = scaledCameraMatrix(intrinsics, frame.size());
+    const Mat &distCoeffs = intrinsics.distCoeffs;
+    
+    drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners2D, found);
+    
+    // Solve pose and project virtual object
+    Mat rvec, tvec;
+    solvePnP(objectPoints, corners2D, scaledCamMatrix, distCoeffs, rvec, tvec);
+    
+    // Render the filled, depth-tested virtual object
+    LodSelector selector;
+    int level = selector.select(virtualObject, rvec, tvec, scaledCamMatrix);
+    MeshRenderer renderer;
+    renderer.render(frame, virtualObject.levels[level].mesh, rvec, tvec, scaledCamMatrix, distCoeffs);
+    if (metrics) renderMetrics(*metrics, selector, virtualObject, renderer.stats());
+    
+    // Draw coordinate axes
+    drawPoseAxes(frame, rvec, tvec, scaledCamMatrix, distCoeffs, 2 * squareSize);
+    return true;
+}
+
+// Calibration for images of imageSize (loadCameraIntrinsics: that resolution
+// first, else the closest one to rescale), from the store opened once in main.
+// Older YAML files carry no image_width/image_height: assume VGA calibration.
+bool intrinsicsForSize(const IntrinsicsStore &store, const string &cameraId, Size imageSize,
+                       CameraIntrinsics &intrinsics) {
+    if (!loadCameraIntrinsics(store, cameraId, imageSize, intrinsics)) return false;
+    if (intrinsics.imageSize.area() == 0) intrinsics.imageSize = Size(640, 480);
+    return true;
 }
 
 int main(int argc, char** argv) {
@@ -115,28 +205,84 @@ int main(int argc, char** argv) {
     const float squareSize = 1.0f;
     
     // Generate 3D checkerboard points
-    vector<Point3f> objectPoints;
-    for (int i = 0; i < boardHeight; i++) {
-        for (int j = 0; j < boardWidth; j++) {
-            objectPoints.push_back(Point3f(j * squareSize, i * squareSize, 0));
-        }
-    }
+    vector<Point3f> objectPoints = boardObjectPoints(Size(boardWidth, boardHeight), squareSize);
     
-    // Load calibration
-    Mat cameraMatrix, distCoeffs;
-    if (!readCameraParameters("camera_intrinsics.yml", cameraMatrix, distCoeffs)) {
-        return -1;
+    // Calibration is looked up per image / capture size in one mapping of the store
+    string cameraId = cameraIdFromArgs(argc, argv);
+    IntrinsicsStore intrinsicsStore;
+    if (!intrinsicsStore.open(DEFAULT_INTRINSICS_STORE)) {
+        cerr << "No intrinsics store " << DEFAULT_INTRINSICS_STORE << ", trying " << DEFAULT_INTRINSICS_YAML << endl;
     }
     
-    int calibWidth = 640;
-    int calibHeight = 480;
+    // Board detector for every mode (batch jobs make their own, see below)
+    unique_ptr<BoardDetector> detector = createBoardDetector(argc, argv);
     
-    // Create virtual object
-    vector<pair<Point3f, Point3f>> virtualObjectLines;
-    createVirtualObject(virtualObjectLines);
+    // Create virtual object: a mesh file if given, else the house
+    Mesh mesh;
+    string meshFile;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--mesh") meshFile = argv[i + 1];
+    }
+    if (!meshFile.empty()) {
+        if (!loadMesh(meshFile, mesh)) return -1;
+        placeOnBoard(mesh, 4.5f, 2.5f, 5.0f);
+        cout << "Loaded " << meshFile << ": " << mesh.numVertices() << " vertices, "
+             << mesh.faces.size() << " triangles" << endl;
+    } else {
+        createVirtualObject(mesh);
+    }
+    
+    // Simplified levels are built once here, not per frame
+    MeshLod virtualObject = buildLodChain(mesh);
+    for (size_t k = 1; k < virtualObject.levels.size(); k++) {
+        cout << "  LOD " << k << ": " << virtualObject.levels[k].mesh.faces.size() << " triangles" << endl;
+    }
     
     // Check mode
-    bool staticImageMode = (argc > 1);
+    bool staticImageMode = (argc > 1 && argv[1][0] != '-');
+    
+    // Batch mode: whole directories or file lists, no GUI
+    string batchSource;
+    BatchOptions batchOptions;
+    if (parseBatchArgs(argc, argv, batchSource, batchOptions)) {
+        vector<string> inputs = collectBatchInputs(batchSource);
+        if (inputs.empty()) {
+            cerr << "Error: No images found in " << batchSource << endl;
+            return -1;
+        }
+        cout << "Processing " << inputs.size() << " images..." << endl;
+        // Detectors keep state (auto selection) and jobs run in parallel: one
+        // detector per worker thread, kept for all the images it processes
+        string detectorName = detectorNameFromArgs(argc, argv);
+        if (!createBoardDetector(detectorName)) detectorName = "auto";
+        int failures = runBatch(inputs, [&](BatchJob &job) {
+            thread_local unique_ptr<BoardDetector> jobDetector;
+            if (!jobDetector) {
+                jobDetector = createBoardDetector(detectorName);
+                jobDetector->setSubpixMethod(detector->subpixMethod());
+            }
+            // Batches are mostly one size: keep the last lookup per worker
+            thread_local Size intrinsicsSize;
+            thread_local CameraIntrinsics intrinsics;
+            thread_local bool haveIntrinsics = false;
+            if (job.image.size() != intrinsicsSize) {
+                haveIntrinsics = intrinsicsForSize(intrinsicsStore, cameraId, job.image.size(), intrinsics);
+                intrinsicsSize = job.image.size();
+            }
+            if (!haveIntrinsics) {
+                job.status = "no_calibration";
+                return false;
+            }
+            if (!renderStaticImage(job.image, *jobDetector, objectPoints, intrinsics, virtualObject, squareSize,
+                                   &job.info)) {
+                job.status = "no_checkerboard";
+                return false;
+            }
+            return true;
+        }, batchOptions);
+        cout << "Done: " << inputs.size() - failures << " succeeded, " << failures << " failed" << endl;
+        return failures == 0 ? 0 : 1;
+    }
     
     // Static image mode
     if (staticImageMode) {
@@ -146,62 +292,9 @@ int main(int argc, char** argv) {
             return -1;
         }
         
-        Mat gray;
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
-        
-        // Detect checkerboard
-        vector<Point2f> corners2D;
-        bool found = findChessboardCorners(gray, Size(boardWidth, boardHeight), corners2D,
-                                           CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
-        
-        if (found) {
-            // Auto-scale calibration for different resolutions
-            Mat scaledCameraMatrix = cameraMatrix.clone();
-            if (frame.cols != calibWidth || frame.rows != calibHeight) {
-                double scaleX = (double)frame.cols / calibWidth;
-                double scaleY = (double)frame.rows / calibHeight;
-                
-                scaledCameraMatrix.at<double>(0, 0) *= scaleX;  // fx
-                scaledCameraMatrix.at<double>(1, 1) *= scaleY;  // fy
-                scaledCameraMatrix.at<double>(0, 2) *= scaleX;  // cx
-                scaledCameraMatrix.at<double>(1, 2) *= scaleY;  // cy
-            }
-            
-            // Refine corners
-            cornerSubPix(gray, corners2D, Size(11, 11), Size(-1, -1),
-                         TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.1));
-            
-            drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners2D, found);
-            
-            // Solve pose and project virtual object
-            Mat rvec, tvec;
-            solvePnP(objectPoints, corners2D, scaledCameraMatrix, distCoeffs, rvec, tvec);
-            
-            // Project virtual object edges
-            for (const auto &line : virtualObjectLines) {
-                vector<Point3f> points3D = {line.first, line.second};
-                vector<Point2f> points2D;
-                projectPoints(points3D, rvec, tvec, scaledCameraMatrix, distCoeffs, points2D);
-                
-                if (points2D.size() == 2) {
-                    cv::line(frame, points2D[0], points2D[1], Scalar(255, 255, 0), 3, LINE_AA);
-                }
-            }
-            
-            // Draw coordinate axes
-            vector<Point3f> axisPoints = {
-                Point3f(0, 0, 0),
-                Point3f(2*squareSize, 0, 0),
-                Point3f(0, 2*squareSize, 0),
-                Point3f(0, 0, -2*squareSize)
-            };
-            vector<Point2f> imageAxisPoints;
-            projectPoints(axisPoints, rvec, tvec, scaledCameraMatrix, distCoeffs, imageAxisPoints);
-            
-            cv::line(frame, imageAxisPoints[0], imageAxisPoints[1], Scalar(0, 0, 255), 2);
-            cv::line(frame, imageAxisPoints[0], imageAxisPoints[2], Scalar(0, 255, 0), 2);
-            cv::line(frame, imageAxisPoints[0], imageAxisPoints[3], Scalar(255, 0, 0), 2);
-            
+        CameraIntrinsics intrinsics;
+        if (!intrinsicsForSize(intrinsicsStore, cameraId, frame.size(), intrinsics)) return -1;
+        if (renderStaticImage(frame, *detector, objectPoints, intrinsics, virtualObject, squareSize)) {
             // Save output
             string outputPath = string(argv[1]);
             size_t dotPos = outputPath.find_last_of(".");
@@ -218,29 +311,24 @@ int main(int argc, char** argv) {
         return 0;
     }
     
-    // Live camera mode
+    // Live camera mode (or a recording of one)
+    bool replaying = !replayFileFromArgs(argc, argv).empty();
     vector<int> availableCameras;
-    
-    for (int i = 0; i < 5; i++) {
-        VideoCapture testCap(i);
-        if (testCap.isOpened()) {
-            Mat testFrame;
-            testCap >> testFrame;
-            if (!testFrame.empty()) {
-                availableCameras.push_back(i);
-            }
-            testCap.release();
-        }
+    if (!replaying) {
+        availableCameras = availableCameraIndices(deviceRootFromArgs(argc, argv),
+                                                  DEFAULT_CAMERA_INVENTORY, false);
     }
     
-    if (availableCameras.empty()) {
+    if (!replaying && availableCameras.empty()) {
         cerr << "ERROR: No cameras found" << endl;
         return -1;
     }
     
     // Select camera
-    int cameraIndex;
-    if (availableCameras.size() == 1) {
+    int cameraIndex = 0;
+    if (replaying) {
+        // Frames come from the recording
+    } else if (availableCameras.size() == 1) {
         cameraIndex = availableCameras[0];
     } else {
         cout << "Enter camera index: ";
@@ -248,72 +336,93 @@ int main(int argc, char** argv) {
     }
     
     // Open camera
-    VideoCapture cap(cameraIndex);
-    if (!cap.isOpened()) {
+    FrameSource cap;
+    if (!cap.open(argc, argv, cameraIndex)) {
         cerr << "Failed to open camera" << endl;
         return -1;
     }
     
     int screenshotCount = 0;
     
+    // Intrinsics for the current capture size, looked up only when it changes
+    CameraIntrinsics intrinsics;
+    Mat cameraMatrix, distCoeffs;
+    Size cameraMatrixSize;
+    
+    FramePyramid pyramid;  // Level buffers persist across frames
+    MeshRenderer renderer;  // Overlay and depth buffers persist across frames
+    LodSelector lodSelector;  // Keeps the current level for hysteresis
+    
+    // Working set reused every frame: the loop does not allocate once warm
+    LumaFrame luma;  // Gray for detection, BGR for rendering
+    vector<Point2f> corners2D;
+    Mat rvec, tvec;
+    string metrics;
+    FrameAllocationMonitor allocations("virtual_object");
+    allocations.configure(argc, argv);
+    FrameScheduler scheduler;
+    scheduler.configure(argc, argv, cap.fps());
+    
     while (true) {
-        Mat frame, gray;
-        cap >> frame;
-        if (frame.empty()) break;
-        
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
+        allocations.beginFrame();
+        cap >> luma;
+        scheduler.beginFrame();  // Processing time starts once the frame is in
+        if (luma.empty()) break;
+        pyramid.reset(luma.gray());
+        Mat &frame = luma.bgr();
         
-        vector<Point2f> corners2D;
-        bool found = findChessboardCorners(gray, Size(boardWidth, boardHeight), corners2D,
-                                           CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
+        if (luma.size() != cameraMatrixSize) {
+            if (!intrinsicsForSize(intrinsicsStore, cameraId, luma.size(), intrinsics)) return -1;
+            cameraMatrix = scaledCameraMatrix(intrinsics, luma.size());
+            distCoeffs = intrinsics.distCoeffs;
+            cameraMatrixSize = luma.size();
+        }
         
+        // Smaller pyramid level while frames run over budget
+        detector->setMaxDetectionWidth(scheduler.degraded() ? reducedDetectionWidth(frame.cols)
+                                                            : DEFAULT_DETECTION_WIDTH);
+        bool found = detector->detect(pyramid, Size(boardWidth, boardHeight), corners2D);
         if (found) {
-            cornerSubPix(gray, corners2D, Size(11, 11), Size(-1, -1),
-                         TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 30, 0.1));
-            
-            drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners2D, found);
-            
-            Mat rvec, tvec;
+            AllocationScope scope("solvePnP");
             solvePnP(objectPoints, corners2D, cameraMatrix, distCoeffs, rvec, tvec);
-            
-            // Project virtual object
-            for (const auto &line : virtualObjectLines) {
-                vector<Point3f> points3D = {line.first, line.second};
-                vector<Point2f> points2D;
-                projectPoints(points3D, rvec, tvec, cameraMatrix, distCoeffs, points2D);
-                
-                if (points2D.size() == 2) {
-                    cv::line(frame, points2D[0], points2D[1], Scalar(255, 255, 0), 2, LINE_AA);
-                }
+        }
+        
+        if (found) {
+            // Render virtual object
+            int level = lodSelector.select(virtualObject, rvec, tvec, cameraMatrix);
+            {
+                AllocationScope scope("drawChessboardCorners");
+                drawChessboardCorners(frame, Size(boardWidth, boardHeight), corners2D, found);
+            }
+            renderer.render(frame, virtualObject.levels[level].mesh, rvec, tvec, cameraMatrix, distCoeffs);
+            renderMetrics(metrics, lodSelector, virtualObject, renderer.stats());
+            {
+                AllocationScope scope("putText");
+                putText(frame, metrics, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(0, 255, 255), 2);
             }
             
-            // Draw axes
-            vector<Point3f> axisPoints = {
-                Point3f(0, 0, 0),
-                Point3f(2*squareSize, 0, 0),
-                Point3f(0, 2*squareSize, 0),
-                Point3f(0, 0, -2*squareSize)
-            };
-            vector<Point2f> imageAxisPoints;
-            projectPoints(axisPoints, rvec, tvec, cameraMatrix, distCoeffs, imageAxisPoints);
-            
-            cv::line(frame, imageAxisPoints[0], imageAxisPoints[1], Scalar(0, 0, 255), 2);
-            cv::line(frame, imageAxisPoints[0], imageAxisPoints[2], Scalar(0, 255, 0), 2);
-            cv::line(frame, imageAxisPoints[0], imageAxisPoints[3], Scalar(255, 0, 0), 2);
+            // Draw coordinate axes
+            drawPoseAxes(frame, rvec, tvec, cameraMatrix, distCoeffs, 2 * squareSize);
         }
         
-        imshow("Virtual Object", frame);
-        
-        char key = (char)waitKey(30);
+        {
+            AllocationScope scope("imshow");
+            imshow("Virtual Object", frame);
+        }
+        char key = (char)scheduler.waitKey();
         if (key == 27) break;
         else if (key == 's' || key == 'S') {
+            // Screenshots are rare and allowed to allocate
+            AllocationScope scope("screenshot");
             screenshotCount++;
             string filename = "virtual_object_screenshot_" + to_string(screenshotCount) + ".png";
             imwrite(filename, frame);
         }
+        allocations.endFrame();
     }
     
+    cout << "Timing: " << scheduler.summary() << endl;
     cap.release();
     destroyAllWindows();
-    return 0;
+    return allocations.finish() ? 0 : 1;
 }